@@ -0,0 +1,32 @@
+#ifndef ATOMS_H
+#define ATOMS_H
+
+#include <vector>
+
+#include "graph.h"
+
+// a component is decomposed only if n * (n + m) stays below this, the cost of computing its elimination order
+constexpr size_t ATOMS_MAX_WORK = size_t(1) << 28;
+
+// Decomposition of a graph by clique separators (Tarjan 1985, with the MCS-M minimal elimination ordering of
+// Berry et al.): atom i is made of the nodes it alone owns plus separators[i], a clique of g that separates them
+// from atoms i + 1 ... (and which is part of those). The last atom of each connected component has an empty
+// separator. A coloring of g needs as many colors as its hardest atom, and colorings of the atoms can always be
+// glued along the separators.
+struct atom_decomposition {
+    // nodes of g in each atom, increasing
+    std::vector<std::vector<unsigned int>> atoms;
+
+    // the clique atom i shares with the atoms after it
+    std::vector<std::vector<unsigned int>> separators;
+};
+
+atom_decomposition decompose_atoms(const graph& g);
+
+// coloring of g from colorings of its atoms (atom_color[i][v] is the color, from 1, of node atoms[i][v]): going
+// from the last atom back, the colors of each one are permuted to agree on its separator. Fills color and
+// returns the number of colors, the largest over the atoms.
+unsigned int glue_colorings(const graph& g, const atom_decomposition& d,
+                            const std::vector<std::vector<unsigned int>>& atom_color, std::vector<unsigned int>& color);
+
+#endif //ATOMS_H
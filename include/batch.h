@@ -0,0 +1,33 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include <mpi.h>
+
+#include "solver.h"
+
+// smallest number of processes a group can have: a root and one worker
+constexpr int MIN_GROUP_SIZE = 2;
+
+// instance of a batch, weighted by its file size as a proxy of how hard it is
+struct batch_instance {
+    std::string path;
+    unsigned long long weight;
+};
+
+// instances listed by source, heaviest first: every .col/.col.b file if source is a directory, otherwise
+// one path per line of the file (blank lines and lines starting with '#' are skipped)
+std::vector<batch_instance> list_instances(const std::string& source);
+
+// sizes of the rank groups a batch uses: each group takes half of the processes still free, down to
+// MIN_GROUP_SIZE, and the last group gets what is left (e.g. 128 -> 64 32 16 8 4 2 2)
+std::vector<int> group_sizes(int n_processes);
+
+// solves every instance of source with the processes of comm (at least MIN_GROUP_SIZE), split into groups of
+// contiguous ranks. Instances are handed out on demand by a dispatcher thread on rank 0: the larger half of
+// the groups takes the heaviest instance left, the smaller half the lightest one, so big instances end up on
+// big groups and small groups never wait behind them. Each instance has opt.time_limit seconds.
+void run_batch(const std::string& source, MPI_Comm comm, const solver_options& opt);
+
+#endif //BATCH_H
@@ -0,0 +1,34 @@
+#ifndef BOUND_H
+#define BOUND_H
+
+#include <vector>
+
+#include "solution.h"
+
+// Lower bound on the colors of every complete coloring below a partial one, cheap enough to evaluate at each
+// search node. A clique Q of uncolored nodes is grown greedily from the most saturated node; its nodes need
+// distinct colors, and at most as many of them as a maximum matching between Q and the colors used so far (node q
+// and color c matched only if no neighbour of q has c) can do without a new color:
+//     bound = tot_colors + |Q| - matching
+// The matching is only computed as far as needed to tell whether the bound reaches the upper bound, and the
+// scratch space is kept between calls, so evaluating the bound does not allocate.
+class clique_bound {
+public:
+    // true if the bound shows that every coloring completing s (uncomplete) uses at least ub colors
+    bool reaches(const solution& s, unsigned int ub);
+
+private:
+    // tries to match clique[i] to a color, moving the nodes already matched along an augmenting path
+    bool augment(const solution& s, unsigned int i);
+
+    std::vector<unsigned int> clique;
+    std::vector<unsigned int> candidates;
+
+    // matched[c - 1]: index in clique of the node color c is matched to, NONE if none
+    std::vector<unsigned int> matched;
+    std::vector<char> visited;
+
+    static constexpr unsigned int NONE = static_cast<unsigned int>(-1);
+};
+
+#endif //BOUND_H
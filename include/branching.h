@@ -0,0 +1,29 @@
+#ifndef BRANCHING_H
+#define BRANCHING_H
+
+#include <string>
+
+// which node a search node branches on
+enum class node_rule {
+    dsatur,             // most distinct colors around it, then smallest index
+    dsatur_degree,      // most distinct colors around it, then most neighbours
+    dsatur_free_degree, // most distinct colors around it, then most uncolored neighbours
+    domain_degree       // fewest colors left to it relative to its uncolored neighbours
+};
+
+// in which order the children of a search node try the colors
+enum class value_rule {
+    first_fit,          // increasing colors, the new color last
+    least_constraining  // the colors the fewest uncolored neighbours could still take first
+};
+
+// parse "dsatur", "dsatur-degree", "dsatur-free-degree" or "domain-degree"; throws std::runtime_error otherwise
+node_rule parse_node_rule(const std::string& name);
+
+// parse "first-fit" or "least-constraining"; throws std::runtime_error otherwise
+value_rule parse_value_rule(const std::string& name);
+
+std::string to_string(node_rule rule);
+std::string to_string(value_rule rule);
+
+#endif //BRANCHING_H
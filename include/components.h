@@ -0,0 +1,15 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <vector>
+
+#include "graph.h"
+
+// connected components of g, each as the increasing list of its nodes; smallest components first
+std::vector<std::vector<unsigned int>> connected_components(const graph& g);
+
+// DSATUR greedy coloring: the uncolored node with most distinct colors around it (then most neighbours) takes
+// the smallest free color. Fills color (colors from 1) and returns the number of colors used.
+unsigned int greedy_coloring(const graph& g, std::vector<unsigned int>& color);
+
+#endif //COMPONENTS_H
@@ -0,0 +1,81 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include <mpi.h>
+
+#include "branching.h"
+#include "graph.h"
+
+struct symmetry;
+
+// state of one coloring problem: the graph, its size and the bounds on the number of colors.
+// Solutions and helper threads refer to a context instead of process-wide globals, so a process
+// can hold (and solve) several problems side by side.
+struct context {
+
+    using clock = std::chrono::steady_clock;
+
+    explicit context(const graph* g, MPI_Comm comm = MPI_COMM_WORLD, MPI_Comm control_comm = MPI_COMM_WORLD,
+                     clock::time_point deadline = clock::time_point::max())
+        : g(g), dim(g->dim), comm(comm), control_comm(control_comm), deadline(deadline),
+          colors_ub(g->dim + 1), colors_lb(0), stop(false) {}
+
+    context(const context&) = delete;
+    context& operator=(const context&) = delete;
+
+    const graph* g;
+
+    // number of nodes of g
+    size_t dim;
+
+    // processes cooperating on this problem: point-to-point traffic and barriers go through comm,
+    // the control messages root broadcasts to the workers' listener threads through control_comm
+    MPI_Comm comm;
+    MPI_Comm control_comm;
+
+    // the search gives up at this point in time
+    clock::time_point deadline;
+
+    // search threads of each worker process
+    unsigned int threads = 1;
+
+    // how the workers' search picks the node to branch on and orders its colors
+    node_rule branch_node = node_rule::dsatur;
+    value_rule branch_value = value_rule::first_fit;
+
+    // automorphisms of g the search may use to skip symmetric branches (none if null)
+    const symmetry* sym = nullptr;
+
+    // nodes of a clique of g, colored 1, 2, ... in this order at the root before any branching: every coloring
+    // gives a clique distinct colors, so naming them this way loses none (set on rank 0 only)
+    std::vector<unsigned int> clique;
+
+    // bounds on the number of colors, updated by listener threads while the search runs: a coloring with
+    // colors_lb colors is optimal, so the search stops as soon as colors_ub gets there
+    std::atomic<unsigned int> colors_ub;
+    std::atomic<unsigned int> colors_lb;
+
+    // lowers colors_ub to value if that improves it, even with other threads doing the same; true if it did
+    bool improve_ub(const unsigned int value) {
+        unsigned int ub = colors_ub;
+        while (value < ub)
+            if (colors_ub.compare_exchange_weak(ub, value)) return true;
+        return false;
+    }
+
+    // raised when the search has to give up (time limit), or on root once the search is over
+    std::atomic<bool> stop;
+
+    // root only: serializes control broadcasts, and wakes the timer up when the search ends early
+    std::mutex control_mutex;
+    std::condition_variable control_cv;
+    bool control_closed = false;
+    bool finished = false;
+};
+
+#endif //CONTEXT_H
@@ -0,0 +1,47 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+// Seeded generators of synthetic instances. Random choices come from a splitmix64 stream seeded with seed
+// (no std:: distributions), so the same parameters and seed give the same graph on any platform.
+// All generators return a graph with adjacency lists built and edges set to the number of distinct edges.
+
+// Erdos-Renyi G(n, p): every pair is an edge with probability p
+graph random_graph(size_t n, double p, uint64_t seed);
+
+// queen graph of a rows x cols chessboard: squares are adjacent if a queen moves from one to the other
+graph queen_graph(size_t rows, size_t cols);
+
+// Mycielski graph with the DIMACS numbering: mycielski_graph(k) is triangle-free with chromatic number k + 1
+// (mycielski_graph(1) = K2, mycielski_graph(3) = myciel3.col, 11 nodes)
+graph mycielski_graph(unsigned int k);
+
+// Leighton-style graph: n nodes split into k hidden color classes, with cliques across distinct classes planted
+// until about m edges exist; one k-clique is always planted, so the chromatic number is exactly k
+graph leighton_graph(size_t n, unsigned int k, size_t m, uint64_t seed);
+
+// flat graph: n nodes split into k equal hidden color classes, every pair of classes joined by p * |A| * |B|
+// edges spread so that degrees inside a class differ by at most one per class pair; k-colorable by construction
+graph flat_graph(size_t n, unsigned int k, double p, uint64_t seed);
+
+// random geometric graph: n points uniform in the unit square, joined when their distance is at most r
+graph geometric_graph(size_t n, double r, uint64_t seed);
+
+// builds a graph from a family name and its parameters, as given on the command line of graph-gen
+// (e.g. family "gnp", params {"500", "0.5"}); throws std::runtime_error on unknown families or bad parameters
+graph generate_graph(const std::string& family, const std::vector<std::string>& params, uint64_t seed);
+
+// one line per family: name, parameters and meaning
+std::string generator_usage();
+
+// writes g in DIMACS text format ("p edge", one "e" line per edge, nodes numbered from 1);
+// comment is written as "c" lines before the problem line
+void write_dimacs(const graph& g, std::ostream& out, const std::string& comment = "");
+
+#endif //GENERATOR_H
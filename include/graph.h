@@ -1,33 +1,222 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
-#include <random>
+#include <new>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+// allocator returning storage aligned to a cache line, used for the adjacency rows
+template <typename T, size_t Align = 64>
+struct aligned_allocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = aligned_allocator<U, Align>; };
+
+    aligned_allocator() = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const aligned_allocator<U, Align>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const aligned_allocator<U, Align>&) const { return false; }
+};
+
+// contiguous array that either owns its (cache-line aligned) elements or views elements owned by someone
+// else, e.g. an MPI shared-memory window. Views are read-only by convention and are never freed here.
+template <typename T>
+class aligned_array {
+public:
+    aligned_array() = default;
+
+    aligned_array(const aligned_array& other) { *this = other; }
+
+    aligned_array(aligned_array&& other) noexcept { *this = std::move(other); }
+
+    aligned_array& operator=(const aligned_array& other) {
+        if (this == &other) return *this;
+        if (other.is_view()) {
+            view(other.ptr, other.n);
+        } else {
+            owned = other.owned;
+            ptr = owned.data();
+            n = owned.size();
+        }
+        return *this;
+    }
+
+    aligned_array& operator=(aligned_array&& other) noexcept {
+        const bool was_view = other.is_view();
+        owned = std::move(other.owned);
+        ptr = was_view ? other.ptr : owned.data();
+        n = other.n;
+        other.ptr = nullptr;
+        other.n = 0;
+        return *this;
+    }
+
+    void assign(size_t count, const T& value) {
+        owned.assign(count, value);
+        ptr = owned.data();
+        n = count;
+    }
+
+    template <typename It>
+    void assign(It first, It last) {
+        owned.assign(first, last);
+        ptr = owned.data();
+        n = owned.size();
+    }
+
+    void resize(size_t count) {
+        owned.resize(count);
+        ptr = owned.data();
+        n = count;
+    }
+
+    // drops the owned elements and views [p, p + count) instead
+    void view(T* p, size_t count) {
+        owned.clear();
+        owned.shrink_to_fit();
+        ptr = p;
+        n = count;
+    }
+
+    bool is_view() const { return ptr != nullptr && ptr != owned.data(); }
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    size_t size() const { return n; }
+
+    T& operator[](size_t k) { return ptr[k]; }
+    const T& operator[](size_t k) const { return ptr[k]; }
+
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + n; }
+
+    bool operator==(const aligned_array& other) const {
+        return n == other.n && std::equal(begin(), end(), other.begin());
+    }
+
+private:
+    std::vector<T, aligned_allocator<T>> owned;
+    T* ptr = nullptr;
+    size_t n = 0;
+};
 
 struct graph {
 
+    // a row of the adjacency matrix is a sequence of 64-bit words, padded to a whole number of cache lines
+    static constexpr size_t word_bits = 64;
+    static constexpr size_t line_words = 64 / sizeof(uint64_t);
+
+    using word = uint64_t;
+
     graph();
 
     explicit graph(const std::string& file_path);
 
-    graph(size_t d, double density);
+    // number of nodes, and number of edges declared by the input file
+    size_t dim = 0;
+    size_t edges = 0;
+
+    // number of words in each (padded) row of the adjacency matrix
+    size_t row_words = 0;
+
+    // incident matrix, bit-packed: bit j of row i is set iff (i, j) is an edge
+    aligned_array<word> m;
+
+    // compressed sparse row adjacency lists, built from the matrix once the graph is loaded:
+    // the neighbours of node i are adj[adj_offset[i]] ... adj[adj_offset[i + 1] - 1], sorted
+    aligned_array<unsigned int> adj_offset;
+    aligned_array<unsigned int> adj;
+
+    // label in the input file of each node, when the nodes have been relabelled (empty otherwise).
+    // Only known on the process that loaded the graph: it is neither cached nor sent to the other processes
+    std::vector<unsigned int> original_id;
+
+    // read-only view over the neighbour list of a node
+    struct neighbor_range {
+        const unsigned int* first;
+        const unsigned int* last;
+
+        const unsigned int* begin() const { return first; }
+        const unsigned int* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
 
-    static size_t dim;
-    static size_t edges;
+    // number of words in a padded row of a d x d matrix
+    static size_t words_per_row(size_t d);
 
-    // incident matrix
-    std::vector<std::vector<bool>> m;
+    // allocates an empty d x d adjacency matrix (and sets dim)
+    void resize(size_t d);
 
-    bool operator()(unsigned int i, unsigned int j) const;
+    // (re)builds adj_offset and adj from the adjacency matrix
+    void build_adjacency_lists();
+
+    // subgraph induced by nodes: its node v is node nodes[v] of this graph (edges counts its edges, original_id
+    // is left empty)
+    graph induced_subgraph(const std::vector<unsigned int>& nodes) const;
+
+    neighbor_range neighbors(const unsigned int i) const {
+        return { adj.data() + adj_offset[i], adj.data() + adj_offset[i + 1] };
+    }
+
+    // sets the (symmetric) edge (i, j)
+    void add_edge(unsigned int i, unsigned int j) {
+        m[i * row_words + j / word_bits] |= word(1) << (j % word_bits);
+        m[j * row_words + i / word_bits] |= word(1) << (i % word_bits);
+    }
+
+    // unchecked probe of the adjacency matrix
+    bool operator()(const unsigned int i, const unsigned int j) const {
+        return (m[i * row_words + j / word_bits] >> (j % word_bits)) & 1;
+    }
+
+    // pointer to the first word of the adjacency row of node i
+    const word* row(const unsigned int i) const { return m.data() + i * row_words; }
+
+    // number of neighbours of node i
+    size_t degree(unsigned int i) const;
+
+    // number of common neighbours of nodes i and j
+    size_t common_neighbors(unsigned int i, unsigned int j) const;
+
+    // number of neighbours of node i among the nodes set in mask (a row_words long bitset)
+    size_t count_neighbors_in(unsigned int i, const word* mask) const;
+
+    // out = row(i) & mask, both row_words long
+    void intersect_row(unsigned int i, const word* mask, word* out) const;
+
+    static size_t popcount(const word* w, size_t n) {
+        size_t count = 0;
+        for (size_t k = 0; k < n; ++k) count += __builtin_popcountll(w[k]);
+        return count;
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const graph& g) {
-        for (unsigned int i = 0; i < graph::dim; ++i) {
-            for (unsigned int j = 0; j < graph::dim; ++j) {
-                os << g.m[i][j] << "  ";
+        for (unsigned int i = 0; i < g.dim; ++i) {
+            for (unsigned int j = 0; j < g.dim; ++j) {
+                os << g(i, j) << "  ";
             }
             os << "\n";
         }
@@ -0,0 +1,52 @@
+#ifndef GRAPH_CACHE_H
+#define GRAPH_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "graph.h"
+
+// Binary graph cache, stored next to the text instance as "<file>.gcb".
+// Layout: a graph_cache_header followed by the payload, either
+//  - CSR:    (nodes + 1) uint32 offsets, then adj_size uint32 neighbours
+//  - BITSET: nodes rows of row_words uint64 words, as in graph::m
+// whichever is smaller for the graph at hand.
+
+constexpr char GRAPH_CACHE_MAGIC[8] = {'G', 'C', 'O', 'L', 'B', 'I', 'N', '\0'};
+constexpr uint32_t GRAPH_CACHE_VERSION = 1;
+
+constexpr uint32_t PAYLOAD_CSR = 0;
+constexpr uint32_t PAYLOAD_BITSET = 1;
+
+struct graph_cache_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t payload;
+    uint64_t nodes;
+    uint64_t edges;         // edges declared by the "p edge" line
+    uint64_t adj_size;      // entries of the CSR neighbour array
+    uint64_t source_size;   // size in bytes of the text file the cache was built from
+    uint64_t payload_bytes;
+    uint64_t checksum;      // FNV-1a over the payload, 32-bit words at a time
+};
+
+// path of the cache file belonging to a text instance
+std::string graph_cache_path(const std::string& file_path);
+
+// writes g to cache_path (atomically, via a temporary file and rename); returns false on failure
+bool write_graph_cache(const graph& g, const std::string& cache_path, uint64_t source_size);
+
+// maps cache_path and loads it into g; returns false if the file is missing, stale or corrupted
+bool read_graph_cache(graph& g, const std::string& cache_path, uint64_t source_size);
+
+// loads a text instance, reading its cache when it is up to date and (re)writing it otherwise
+graph load_graph(const std::string& file_path, bool use_cache = true);
+
+// true for the instance formats the solver reads: DIMACS text (.col) and DIMACS binary (.col.b)
+bool is_instance_file(const std::filesystem::path& path);
+
+// parses every .col and .col.b file of a directory and writes its cache; returns the number of files converted
+size_t convert_directory(const std::string& dir_path);
+
+#endif //GRAPH_CACHE_H
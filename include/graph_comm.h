@@ -0,0 +1,32 @@
+#ifndef GRAPH_COMM_H
+#define GRAPH_COMM_H
+
+#include <mpi.h>
+
+#include "graph.h"
+
+// encodings used on the wire by broadcast_graph, chosen per graph to minimise the payload
+constexpr unsigned int WIRE_BITSET = 0;   // strict upper triangle of the matrix, row-major, one bit per pair
+constexpr unsigned int WIRE_CSR = 1;      // for each node i: its number of neighbours j > i, then those neighbours
+
+// number of 32-bit words sent per MPI_Ibcast; the next chunk is in flight while the previous one is decoded
+constexpr size_t BROADCAST_CHUNK_WORDS = 1 << 18;
+
+// sends g from root to every process of comm; on the other processes g is rebuilt (matrix and neighbour lists)
+void broadcast_graph(graph &g, int root, MPI_Comm comm);
+
+// a graph stored once per node in an MPI-3 shared-memory window
+struct shared_graph_window {
+    MPI_Comm node_comm = MPI_COMM_NULL;   // processes of comm sharing this node's memory
+    MPI_Comm leaders = MPI_COMM_NULL;     // one process per node (node rank 0), MPI_COMM_NULL elsewhere
+    MPI_Win win = MPI_WIN_NULL;
+};
+
+// sends g from root to every process of comm, keeping a single read-only copy per node: node leaders receive it
+// with broadcast_graph and copy it into a shared window, then every process points g into it.
+// The returned window must outlive every use of g and be released with free_shared_graph.
+shared_graph_window share_graph(graph &g, int root, MPI_Comm comm);
+
+void free_shared_graph(shared_graph_window &w);
+
+#endif //GRAPH_COMM_H
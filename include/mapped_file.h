@@ -0,0 +1,23 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+
+// read-only memory mapping of a whole file, unmapped on destruction
+struct mapped_file {
+
+    explicit mapped_file(const std::string& file_path);
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + size; }
+
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+#endif //MAPPED_FILE_H
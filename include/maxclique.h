@@ -1,9 +1,17 @@
 #ifndef MAXCLIQUE_H
 #define MAXCLIQUE_H
 
+#include <atomic>
+#include <vector>
+
 #include "graph.h"
 
-// Function that returns the dimension of max clique in the graph
-int find_max_clique(const graph &g);
+// Function that returns the nodes of a max clique in the graph.
+// If stop is raised the search returns early with the largest clique found so far.
+std::vector<unsigned int> find_max_clique(const graph &g, const std::atomic<bool> &stop);
+
+// Nodes of a clique built greedily (a quick lower bound, not always the maximum): from every node,
+// repeatedly add the candidate of largest degree among the nodes adjacent to the whole clique.
+std::vector<unsigned int> greedy_clique(const graph &g);
 
 #endif // MAXCLIQUE_H
@@ -0,0 +1,41 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <climits>
+#include <vector>
+
+#include "graph.h"
+
+// marks a node removed because of its degree rather than dominated by another node
+constexpr unsigned int NO_DOMINATOR = UINT_MAX;
+
+// Nodes that can always be colored once the rest of the graph is, peeled off before the search:
+//  - a node with fewer than lower_bound neighbours left (lower_bound being the size of a clique of the graph)
+//    finds a free color among the first lower_bound ones, and the graph needs that many colors anyway
+//  - a node u whose neighbours are all neighbours of a node v not adjacent to u can take the color of v
+// The rules are applied until neither removes anything; what is left is the kernel.
+struct reduction {
+    // clique size the degree rule was applied with
+    unsigned int lower_bound = 0;
+
+    // kernel node v is node kernel_nodes[v] of the reduced graph
+    std::vector<unsigned int> kernel_nodes;
+
+    // removed nodes, in removal order, and the node each one is dominated by (NO_DOMINATOR for the degree rule)
+    std::vector<unsigned int> removed;
+    std::vector<unsigned int> dominator;
+
+    // number of nodes removed by each rule
+    size_t low_degree = 0;
+    size_t dominated = 0;
+};
+
+reduction reduce_graph(const graph& g, unsigned int lower_bound);
+
+// extends a coloring of the kernel (kernel_color[v] for kernel node v, colors from 1) to every node of g, putting
+// the removed nodes back in reverse order. Colors are renumbered 1 ... k in order of first use; returns k, which
+// is at most max(colors of the kernel, lower_bound).
+unsigned int extend_coloring(const graph& g, const reduction& r, const std::vector<unsigned int>& kernel_color,
+                             std::vector<unsigned int>& color);
+
+#endif //REDUCE_H
@@ -0,0 +1,32 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+// relabellings of the nodes applied once the graph is loaded, so that nodes probed together sit close together
+// in the adjacency matrix
+enum class vertex_order {
+    none,           // keep the order of the input file
+    degeneracy,     // smallest-last order, reversed: the densest core comes first
+    rcm,            // reverse Cuthill-McKee: small bandwidth, neighbours get nearby labels
+    degree          // decreasing degree
+};
+
+// parses "none", "degeneracy", "rcm" or "degree"; throws std::runtime_error otherwise
+vertex_order parse_vertex_order(const std::string& name);
+
+std::string to_string(vertex_order order);
+
+// new labelling of g: order[v] is the current label of the node that gets label v
+std::vector<unsigned int> compute_order(const graph& g, vertex_order order);
+
+// copy of g with node order[v] relabelled v; original_id keeps track of the labels of the input file
+graph permute_graph(const graph& g, const std::vector<unsigned int>& order);
+
+// largest |i - j| over the edges (i, j) of g
+size_t bandwidth(const graph& g);
+
+#endif //REORDER_H
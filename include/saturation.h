@@ -0,0 +1,104 @@
+#ifndef SATURATION_H
+#define SATURATION_H
+
+#include <vector>
+
+#include "graph.h"
+
+// DSATUR bookkeeping of a partial coloring, kept up to date one assignment at a time instead of being recomputed
+// for every search node:
+//  - count[c - 1][v]: neighbours of v with color c, so v can take c iff it is 0
+//  - first[c - 1][v]: the first of those colored (the last uncolored, since assignments are undone in reverse)
+//  - saturation[v]: number of distinct colors among the neighbours of v
+//  - free_degree[v]: number of uncolored neighbours of v
+//  - the uncolored nodes in buckets by saturation (doubly linked lists), to find the most saturated one
+// assign and unassign cost O(degree) and undo each other exactly.
+class saturation_state {
+public:
+    saturation_state() = default;
+
+    // state of the coloring color (0 for uncolored nodes) of g
+    void reset(const graph& g, const std::vector<unsigned int>& color);
+
+    // node v, uncolored, takes color c
+    void assign(const graph& g, unsigned int v, unsigned int c);
+
+    // node v, last assigned color c, is uncolored again
+    void unassign(const graph& g, unsigned int v, unsigned int c);
+
+    // true if no neighbour of v has color c
+    bool allowed(const unsigned int v, const unsigned int c) const {
+        return c > colors || count[static_cast<size_t>(c - 1) * n + v] == 0;
+    }
+
+    // neighbour of v colored c before the others, when allowed(v, c) is false
+    unsigned int first_neighbor(const unsigned int v, const unsigned int c) const {
+        return first[static_cast<size_t>(c - 1) * n + v];
+    }
+
+    unsigned int saturation(const unsigned int v) const { return sat[v]; }
+
+    unsigned int free_degree(const unsigned int v) const { return free_deg[v]; }
+
+    bool is_colored(const unsigned int v) const { return colored[v]; }
+
+    // largest saturation of an uncolored node, 0 if every node is colored
+    unsigned int max_saturation() const {
+        for (unsigned int s = top + 1; s-- > 0;)
+            if (head[s] != NONE) return s;
+        return 0;
+    }
+
+    // some uncolored node of saturation s, n if there is none
+    unsigned int with_saturation(const unsigned int s) const {
+        return s <= n && head[s] != NONE ? head[s] : n;
+    }
+
+    // uncolored node with the largest saturation, the smallest index on ties; n if every node is colored
+    unsigned int pick() const {
+        return pick([](const unsigned int a, const unsigned int b) { return a < b; });
+    }
+
+    // uncolored node with the largest saturation, ties going to the node a for which better(a, b) holds against
+    // the others; n if every node is colored
+    template <typename Better>
+    unsigned int pick(Better better) const {
+        for (unsigned int s = top + 1; s-- > 0;) {
+            if (head[s] == NONE) continue;
+
+            unsigned int best = head[s];
+            for (unsigned int v = next[best]; v != NONE; v = next[v])
+                if (better(v, best)) best = v;
+            return best;
+        }
+        return n;
+    }
+
+private:
+    static constexpr unsigned int NONE = static_cast<unsigned int>(-1);
+
+    void insert(unsigned int v);
+    void erase(unsigned int v);
+
+    // raises (up = true) or lowers the number of neighbours of u with color c, v being the one colored or uncolored
+    void update(unsigned int u, unsigned int c, unsigned int v, bool up);
+
+    unsigned int n = 0;
+
+    // number of colors with a row in count
+    unsigned int colors = 0;
+
+    std::vector<unsigned int> count;
+    std::vector<unsigned int> first;
+    std::vector<unsigned int> sat;
+    std::vector<unsigned int> free_deg;
+
+    // head[s]: first uncolored node of saturation s; prev / next link the nodes of a bucket, NONE ends a list
+    std::vector<unsigned int> head, prev, next;
+    std::vector<char> colored;
+
+    // no bucket above top is ever non-empty
+    unsigned int top = 0;
+};
+
+#endif //SATURATION_H
@@ -0,0 +1,233 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bound.h"
+#include "solution.h"
+
+class work_pool;
+
+// how often (in nodes) a search run by a work_pool checks whether other threads are out of work
+constexpr unsigned long long SPLIT_INTERVAL = 64;
+
+// Branching policies the search is instantiated with (see node_rule and value_rule in branching.h): the choices made
+// at every search node are then inlined rather than dispatched at run time.
+
+// node choices: pick(s) is the uncolored node the children of s color
+struct dsatur_node {
+    static unsigned int pick(const solution& s) { return s.sat.pick(); }
+};
+
+struct dsatur_degree_node {
+    static unsigned int pick(const solution& s) {
+        const graph& g = *s.ctx->g;
+        return s.sat.pick([&g](const unsigned int a, const unsigned int b) {
+            const size_t da = g.neighbors(a).size(), db = g.neighbors(b).size();
+            return da > db || (da == db && a < b);
+        });
+    }
+};
+
+struct dsatur_free_degree_node {
+    static unsigned int pick(const solution& s) {
+        return s.sat.pick([&s](const unsigned int a, const unsigned int b) {
+            const unsigned int da = s.sat.free_degree(a), db = s.sat.free_degree(b);
+            return da > db || (da == db && a < b);
+        });
+    }
+};
+
+struct domain_degree_node {
+    // smallest ratio between the colors a node can take (those used so far and a new one, minus the ones around it)
+    // and its uncolored neighbours, the smallest index on ties
+    static unsigned int pick(const solution& s) {
+        const unsigned int n = static_cast<unsigned int>(s.ctx->dim);
+        unsigned int best = n;
+        unsigned long long best_domain = 0, best_degree = 0;
+
+        for (unsigned int v = 0; v < n; ++v) {
+            if (s.color[v] != 0) continue;
+
+            const unsigned long long domain = s.tot_colors + 1 - s.sat.saturation(v);
+            const unsigned long long degree = s.sat.free_degree(v);
+            if (best == n || domain * best_degree < best_domain * degree) {
+                best = v;
+                best_domain = domain;
+                best_degree = degree;
+            }
+        }
+        return best;
+    }
+};
+
+// color orders: with reorders set, order(s, node, colors, cost) rearranges colors, the colors node can take in
+// increasing order, into the order its children try them (cost is scratch space); otherwise that order is kept
+struct first_fit_values {
+    static constexpr bool reorders = false;
+
+    static void order(const solution&, unsigned int, std::vector<unsigned int>&, std::vector<unsigned int>&) {}
+};
+
+struct least_constraining_values {
+    static constexpr bool reorders = true;
+
+    // first the colors that the fewest uncolored neighbours of node can still take
+    static void order(const solution& s, const unsigned int node, std::vector<unsigned int>& colors,
+                      std::vector<unsigned int>& cost) {
+        cost.assign(s.tot_colors + 2, 0);
+        for (const unsigned int u : s.ctx->g->neighbors(node)) {
+            if (s.color[u] != 0) continue;
+            for (const unsigned int c : colors)
+                if (s.sat.allowed(u, c)) cost[c]++;
+        }
+        std::stable_sort(colors.begin(), colors.end(), [&cost](const unsigned int a, const unsigned int b) {
+            return cost[a] < cost[b];
+        });
+    }
+};
+
+// Depth-first branch and bound below one node of the search tree, as run by a worker. A single coloring is changed
+// in place: every assignment is recorded on a trail and undone when the search backtracks past it, so exploring a
+// node neither copies the coloring nor allocates (the frames and the trail keep their storage). Children are made
+// one at a time when the search gets to them, each frame remembering how far its children got: the search holds
+// O(depth) state, and siblings the upper bound has made useless in the meantime are never generated.
+// After each assignment the search checks forward: a node left without a color below the upper bound (every one
+// of them is around it) prunes the branch at once, and a node left with a single color takes it right away. A
+// node is only expanded while its lower bound (see clique_bound) stays below the upper bound.
+// Backtracking is conflict-directed (Prosser 1993): each assigned node keeps the decision levels its color follows
+// from (its own level for a branching decision; for a forced node, those of the neighbours blocking its other
+// colors), a failure is explained by the levels of the assignments causing it, and once a node has run out of
+// colors the search jumps straight back to the deepest level its failures depend on. The explanations are sets of
+// decisions under which no coloring with labels below the upper bound exists, so they stay valid as the bound
+// drops. Failures involving the symmetry constraints, the clique bound or another thread are blamed on every level
+// above them, which backtracks chronologically.
+// Node picks the node to branch on and Value orders its colors (see above); src/search.cpp instantiates every pair.
+template <typename Node, typename Value>
+class search_engine {
+public:
+    // the search starts from (a copy of) start, a node of the problem ctx. With a pool, it runs on thread thread of
+    // the pool and hands out unexplored children of its shallowest nodes when other threads run out of work
+    search_engine(context& ctx, const solution& start, work_pool* pool = nullptr, unsigned int thread = 0);
+
+    // explores the subtree of the starting node, calling improved with each complete coloring using fewer colors
+    // than ctx->colors_ub (which is lowered to it first). Returns true if the subtree was exhausted, false if the
+    // search stopped before: ctx->stop raised, or colors_ub down to colors_lb
+    bool run(const std::function<void(const solution&)>& improved);
+
+    // number of search nodes visited
+    unsigned long long nodes = 0;
+
+private:
+    // a node being branched on, at some depth, and the nodes symmetric to it. cursor tells how far its children
+    // got: the color of the last one (0 before the first) in increasing order, the number of colors of order tried
+    // when Value reorders
+    struct frame {
+        unsigned int node;
+        unsigned int cursor = 0;
+
+        // size of the trail when the frame was opened: its child being explored made the assignments above
+        size_t mark;
+
+        std::vector<unsigned int> orbit;
+        std::vector<unsigned int> order;
+        std::vector<unsigned int> cost;
+
+        // levels the failures of its children explored so far depend on; full once it has every level above the
+        // frame, after which further failures need not be explained
+        std::vector<uint64_t> conflict;
+        bool full;
+    };
+
+    // undo information of an assignment
+    struct trail_entry {
+        unsigned int node;
+        unsigned int tot_colors;
+        size_t forbidden;
+    };
+
+    // opens a frame for the children of the current coloring
+    void expand();
+
+    // color of the next child of f, s being the coloring at the depth of f: the next color f.node can take that
+    // leaves fewer colors than the upper bound, 0 if there is none. cursor is set past it
+    unsigned int next_color(const solution& s, const frame& f, unsigned int& cursor) const;
+
+    // forbids the colors of the children of f tried before the one ending at cursor to the nodes symmetric to
+    // f.node (see solution::get_next), s being the coloring at the depth of f
+    static void forbid_symmetric(solution& s, const frame& f, unsigned int cursor);
+
+    // applies the child of the deepest frame giving its node color c, cursor being past it
+    void descend(unsigned int c, unsigned int cursor);
+
+    // forward checking on the current coloring: colors the nodes left with a single color below the upper bound,
+    // as long as there are some. Returns false if some node has none left, true otherwise (or if the coloring is
+    // complete or already uses as many colors as the upper bound)
+    bool propagate();
+
+    // gives the pool the next child of the shallowest frame that has one left
+    void split();
+
+    // undoes the assignments made by the child of the deepest frame being explored
+    void undo();
+
+    // the deepest frame has no child left: closes it and the frames above down to the deepest level its failure
+    // depends on (all of them if there is none)
+    void backjump();
+
+    // failed child of the deepest frame: node failed_node wiped out, with the colors up to failed_limit around it,
+    // or anything else if failed_node is NO_NODE
+    void fail();
+
+    // sets levels 0 ... levels - 1 in set
+    void add_levels(uint64_t* set, size_t levels) const;
+
+    // true if set has levels 0 ... levels - 1
+    bool covers(const uint64_t* set, size_t levels) const;
+
+    // adds to set the reasons for the colors 1 ... limit but skip that some neighbour of v has
+    void add_around(unsigned int v, unsigned int limit, unsigned int skip, uint64_t* set);
+
+    // pushes on witnesses, for each color up to limit but skip around v, the neighbour of v colored first with it
+    // if its stamp is below before
+    void collect(unsigned int v, unsigned int limit, unsigned int skip, unsigned int before);
+
+    // reason of the color of v, worked out when first needed for a forced node: the neighbours colored before it
+    // still have the colors that forced it
+    const uint64_t* reason_of(unsigned int v);
+
+    uint64_t* reason_row(const unsigned int v) { return reason.data() + static_cast<size_t>(v) * words; }
+
+    context& ctx;
+    solution cur;
+
+    work_pool* pool;
+    unsigned int thread;
+
+    // frames[0 ... depth - 1] are open. The trail holds the assignments made since the start: those forced at the
+    // start, then for each frame the one of its child being explored and those forced by it
+    std::vector<frame> frames;
+    size_t depth = 0;
+    std::vector<trail_entry> trail;
+
+    clique_bound bound;
+
+    // level sets for backjumping take words words. reason_row(v): the levels of the decisions the color of v
+    // follows from (none for the nodes colored at the start), if explained[v]; stamp[v]: position of the
+    // assignment of v on the trail, plus one (0 at the start), to tell which neighbours were colored before it;
+    // witnesses: stack of the nodes collect finds
+    size_t words;
+    std::vector<uint64_t> reason;
+    std::vector<char> explained;
+    std::vector<unsigned int> stamp;
+    std::vector<unsigned int> witnesses;
+
+    static constexpr unsigned int NO_NODE = static_cast<unsigned int>(-1);
+    unsigned int failed_node = NO_NODE;
+    unsigned int failed_limit = 0;
+};
+
+#endif //SEARCH_H
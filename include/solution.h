@@ -3,21 +3,17 @@
 
 #include <vector>
 #include <mpi.h>
-#include <unordered_set>
 
 #include "graph.h"
+#include "context.h"
+#include "saturation.h"
 
 struct solution {
     // nodes are numbered   [0 to dim-1]
     // colors are numbered  [1 to dim (at most)]
 
-    static size_t dim;
-
-    static graph * g;
-
-    // upper bound on number of colors to use
-    static unsigned int colors_ub;
-    static unsigned int colors_lb;
+    // problem this solution belongs to (graph, dimension, bounds on the number of colors)
+    const context* ctx;
 
     // this array contains the color (repr as an integer) of each node: 0 -> color not assigned yet
     std::vector<unsigned int> color;
@@ -28,22 +24,49 @@ struct solution {
     // index of the first node without a color
     unsigned int next;
 
+    // (node, color) pairs, flattened: colors the node may not take because the branch giving it that color is
+    // symmetric to one already explored (see get_next)
+    std::vector<unsigned int> forbidden;
+
+    // colors around each node, updated as nodes are colored; picks the node to branch on
+    saturation_state sat;
+
     // constructor for an empty solution
-    solution();
+    explicit solution(const context& ctx);
 
     // returns true if all nodes are assigned a color
     bool is_final() const;
 
-    // checks whether a solution is valid, with respect with a single node
-    // i.e. checks whether a node has neighbours of the same color
-    bool is_valid(unsigned int node_to_check) const;
-
-    // returns a list of solutions, "children" of this, each one has a different color for the selected node
+    // returns a list of solutions, "children" of this, each one has a different color for the selected node.
+    // Near the root, if the graph has automorphisms fixing the colored nodes, the child giving color c to node v
+    // is symmetric to the children giving c to the other nodes of the orbit of v: the later siblings forbid c to
+    // those nodes (orbital branching)
     [[nodiscard]] std::vector<solution> get_next() const;
 
-    friend std::ostream& operator<<(std::ostream& os, const solution& sol);
+    // recomputes sat from color, for a solution whose colors were set directly (e.g. received from another process)
+    void rebuild_saturation();
+
+    // node the children of this solution color (DSATUR: the uncolored node with most distinct colors around it)
+    [[nodiscard]] unsigned int branching_node() const;
 
-    static void attach_graph(graph * g);
+    // nodes that an automorphism fixing this partial coloring maps node to, node first; just node when no
+    // symmetry applies
+    void symmetric_nodes(unsigned int node, std::vector<unsigned int>& out) const;
+
+    // forward checking: true if some uncolored node has all the colors below bound around it, so that no coloring
+    // below this one uses fewer than bound colors
+    bool wiped_out(unsigned int bound) const;
+
+    // true if node may take node_color: no neighbour has it and it is not forbidden to node
+    bool can_take(unsigned int node, unsigned int node_color) const;
+
+    // colors node (uncolored so far) in place
+    void assign(unsigned int node, unsigned int node_color);
+
+    // undoes assign(node, ...), tot_colors going back to previous_tot_colors
+    void unassign(unsigned int node, unsigned int previous_tot_colors);
+
+    friend std::ostream& operator<<(std::ostream& os, const solution& sol);
 
     // Writes solution details to a file
     void write_to_file(const std::string& instance_name, unsigned int time_taken, int n_processes, int time_limit_seconds, bool is_optimal) const;
@@ -52,8 +75,6 @@ private:
 
     // constructor for the "child" of the solution
     solution(const solution& parent, unsigned int node_to_color, unsigned int node_color);
-
-    [[nodiscard]] unsigned int node_with_most_colored_neighbors() const;
 };
 
 #endif //SOLUTION_H
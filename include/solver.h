@@ -0,0 +1,70 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <string>
+#include <mpi.h>
+
+#include "graph.h"
+#include "context.h"
+#include "solution.h"
+#include "reorder.h"
+
+// how each graph that needs a search is searched
+enum class decision_mode {
+    // a single search for colorings better than the best known one, down to the lower bound
+    none,
+    // "is it k-colorable?" for k one below the best coloring found, until some k is not
+    down,
+    // "is it k-colorable?" for k at the lower bound, which goes up by one each time some k is not
+    up
+};
+
+// parses "none", "down" or "up"; throws std::runtime_error otherwise
+decision_mode parse_decision_mode(const std::string& name);
+
+std::string to_string(decision_mode mode);
+
+// settings shared by every instance solved in a run
+struct solver_options {
+    // seconds allowed for each instance, graph loading included
+    unsigned int time_limit = 0;
+
+    // read/write the binary graph cache next to the instance
+    bool use_cache = true;
+
+    // peel nodes that can be colored after the others (low degree, dominated) before the search
+    bool reduce = true;
+
+    // split the graph into atoms along clique separators, and color them separately
+    bool decompose = true;
+
+    // look for automorphisms of each graph searched, and skip the branches they make symmetric
+    bool symmetry = true;
+
+    // search threads of each worker process, stealing work from each other
+    unsigned int threads = 1;
+
+    // node the workers' search branches on, and order in which its children try the colors
+    node_rule branch_node = node_rule::dsatur;
+    value_rule branch_value = value_rule::first_fit;
+
+    // optimization search, or a series of decision searches with a fixed number of colors
+    decision_mode decision = decision_mode::none;
+
+    // relabelling applied to the graph once loaded; colors are written back with the labels of the input file
+    vertex_order order = vertex_order::none;
+};
+
+// branch and bound on ctx.g with the processes of ctx.comm: rank 0 expands the first levels of the tree
+// breadth-first and hands one node to each worker, which explores it depth-first.
+// On rank 0 returns the best solution found (not final if none was found) and sets optimal if the tree was
+// fully explored; on the other ranks returns an empty solution.
+solution solve(context& ctx, bool& optimal);
+
+// loads file_path on rank 0 of comm and reduces it; the atoms of the kernel (connected components split along
+// clique separators) are colored smallest first, greedily when that is provably enough and otherwise by solve()
+// with every process of comm (at least 2). Rank 0 writes the coloring of the whole graph through
+// solution::write_to_file
+void solve_instance(const std::string& file_path, MPI_Comm comm, const solver_options& opt);
+
+#endif //SOLVER_H
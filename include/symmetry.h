@@ -0,0 +1,56 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <chrono>
+#include <vector>
+#include <mpi.h>
+
+#include "graph.h"
+
+// automorphisms are only looked for in graphs up to this many nodes
+constexpr size_t SYMMETRY_MAX_NODES = 2000;
+
+// work the automorphism search may spend, counted as the nodes and adjacency entries scanned by its refinement
+// passes; past this the generators found so far are kept
+constexpr size_t SYMMETRY_MAX_WORK = 10000000;
+
+// the automorphism search of a graph about to be colored gets this fraction of the time left
+constexpr unsigned int SYMMETRY_TIME_SHARE = 10;
+
+// the whole group is listed when it has at most this many elements, otherwise only its generators are kept
+constexpr size_t SYMMETRY_MAX_ELEMENTS = 1024;
+
+// symmetries are used while fewer than this many nodes are colored: deeper down the partial colorings have
+// hardly any automorphism left that fixes them
+constexpr unsigned int SYMMETRY_MAX_DEPTH = 32;
+
+// Automorphisms of a graph, found at load time by individualization and refinement (the scheme of nauty): the
+// first leaf of the search tree is compared to leaves of the other branches, level by level from the bottom,
+// and every match is a generator. Branches already known to be equivalent are skipped.
+struct symmetry {
+    // each one maps node v to perms[k][v]: when listed, every element but the identity of the group they generate,
+    // otherwise generators
+    std::vector<std::vector<unsigned int>> perms;
+
+    // perms is a whole group, listed element by element
+    bool listed = false;
+
+    // perms lists every automorphism of the graph (listed, and the search ran to the end)
+    bool complete = false;
+
+    // true if the graph has no automorphism but the identity (as far as the search could tell)
+    bool trivial() const { return perms.empty(); }
+
+    // nodes v can be mapped to by the automorphisms in perms that fix every node of fixed (fixed[u] != 0).
+    // With the whole group listed these are the orbit of v in the stabilizer of fixed; with generators only, part
+    // of it (the orbit in the subgroup generated by the generators that fix those nodes)
+    void orbit(unsigned int v, const std::vector<char>& fixed, std::vector<unsigned int>& out) const;
+};
+
+// automorphisms of g, looked for until deadline: past it the search gives up and none are returned
+symmetry find_symmetries(const graph& g, std::chrono::steady_clock::time_point deadline);
+
+// sends the automorphisms found on root to every process of comm
+void broadcast_symmetry(symmetry& sym, size_t dim, int root, MPI_Comm comm);
+
+#endif //SYMMETRY_H
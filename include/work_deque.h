@@ -0,0 +1,106 @@
+#ifndef WORK_DEQUE_H
+#define WORK_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Chase and Lev 2005, with the C11 memory orderings of Le et al. 2013): the owning
+// thread pushes and pops at the bottom without locking, other threads steal from the top. T has to be trivially
+// copyable (pointers in practice). The circular buffer doubles when full; the buffers it outgrew are only freed
+// with the deque, since a thief may still be reading them.
+template <typename T>
+class work_deque {
+public:
+    explicit work_deque(const size_t capacity = 64) {
+        buffers.push_back(std::make_unique<ring>(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    work_deque(const work_deque&) = delete;
+    work_deque& operator=(const work_deque&) = delete;
+
+    // owner only
+    void push(const T item) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        ring* r = buffer.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(r->size) - 1) r = grow(r, t, b);
+
+        r->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only: the item pushed last, if any is left
+    bool pop(T& item) {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring* r = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = r->get(b);
+        if (t == b) {
+            // last item: race the thieves for it
+            const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // any thread: the oldest item, if any is left and no other thread took it first
+    bool steal(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        const ring* r = buffer.load(std::memory_order_acquire);
+        item = r->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // approximate when other threads are pushing or stealing
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct ring {
+        explicit ring(const size_t size) : size(size), items(new std::atomic<T>[size]) {}
+
+        T get(const int64_t i) const { return items[i & (size - 1)].load(std::memory_order_relaxed); }
+        void put(const int64_t i, const T item) { items[i & (size - 1)].store(item, std::memory_order_relaxed); }
+
+        const size_t size;   // a power of two
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+    ring* grow(const ring* old, const int64_t t, const int64_t b) {
+        buffers.push_back(std::make_unique<ring>(old->size * 2));
+        ring* r = buffers.back().get();
+        for (int64_t i = t; i < b; ++i) r->put(i, old->get(i));
+        buffer.store(r, std::memory_order_release);
+        return r;
+    }
+
+    std::atomic<int64_t> top{0};
+    std::atomic<int64_t> bottom{0};
+    std::atomic<ring*> buffer{nullptr};
+
+    // every buffer allocated so far (owner only)
+    std::vector<std::unique_ptr<ring>> buffers;
+};
+
+#endif //WORK_DEQUE_H
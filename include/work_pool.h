@@ -0,0 +1,66 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "solution.h"
+#include "work_deque.h"
+
+// Threads of one process exploring the subtree of a node together. Each thread runs a search_engine on the
+// subproblems it owns; when some thread runs out of work, the others hand out unexplored children of their
+// shallowest nodes through their own Chase-Lev deque, from which the idle threads steal. The threads share the
+// bounds of the context.
+class work_pool {
+public:
+    work_pool(context& ctx, unsigned int threads);
+    ~work_pool();
+
+    work_pool(const work_pool&) = delete;
+    work_pool& operator=(const work_pool&) = delete;
+
+    // explores the subtree of start, calling improved (one thread at a time) with each coloring better than the
+    // upper bound. Returns true if the subtree was exhausted, false if the search stopped before (see
+    // search_engine::run); nodes is set to the number of nodes visited by all the threads
+    bool run(const solution& start, const std::function<void(const solution&)>& improved, unsigned long long& nodes);
+
+    // true if some thread is waiting for work and thread has none queued
+    bool hungry(const unsigned int thread) const {
+        return idle.load(std::memory_order_relaxed) > 0 && deques[thread]->empty();
+    }
+
+    // queues a subproblem found by thread for the others to steal
+    void give(unsigned int thread, solution&& node);
+
+private:
+    // runs work<Node, Value> with the branching policies of the context
+    void work(unsigned int thread);
+
+    template <typename Node, typename Value>
+    void work(unsigned int thread);
+
+    // takes a subproblem: from the own deque first, then from the others
+    bool take(unsigned int thread, solution*& node);
+
+    context& ctx;
+    const unsigned int threads;
+    std::vector<std::unique_ptr<work_deque<solution*>>> deques;
+
+    // subproblems queued or being explored: the search is over when it drops to 0
+    std::atomic<long> pending{0};
+
+    // threads looking for work
+    std::atomic<unsigned int> idle{0};
+
+    // some search stopped before exhausting its subtree
+    std::atomic<bool> interrupted{false};
+
+    const std::function<void(const solution&)>* improved = nullptr;
+    std::mutex improved_mutex;
+    std::atomic<unsigned long long> nodes_visited{0};
+};
+
+#endif //WORK_POOL_H
@@ -0,0 +1,203 @@
+#include "atoms.h"
+#include "components.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr unsigned int UNNUMBERED = static_cast<unsigned int>(-1);
+
+// MCS-M (Berry, Blair, Heggernes and Peyton): numbers the nodes from n - 1 down to 0, always picking the one of
+// largest weight; the weight of u grows when the node just numbered reaches it through unnumbered nodes all
+// lighter than u. Eliminating nodes in increasing number then is a minimal elimination ordering, and madj[x]
+// collects the neighbours of x in the minimal triangulation that are eliminated after x.
+void mcs_m(const graph& h, std::vector<unsigned int>& order, std::vector<std::vector<unsigned int>>& madj) {
+    const size_t n = h.dim;
+
+    std::vector<unsigned int> weight(n, 0), number(n, UNNUMBERED), reached(n, 0);
+    std::vector<std::vector<unsigned int>> reach(n);
+    std::vector<unsigned int> raised;
+
+    order.assign(n, 0);
+    madj.assign(n, {});
+
+    for (size_t i = n; i-- > 0;) {
+        unsigned int v = UNNUMBERED;
+        for (unsigned int u = 0; u < n; ++u)
+            if (number[u] == UNNUMBERED && (v == UNNUMBERED || weight[u] > weight[v])) v = u;
+
+        number[v] = static_cast<unsigned int>(i);
+        order[i] = v;
+
+        // reach[j]: nodes reached through paths whose heaviest inner node weighs j
+        const unsigned int stamp = static_cast<unsigned int>(n - i);
+        reached[v] = stamp;
+        raised.clear();
+        for (const unsigned int u : h.neighbors(v)) {
+            if (number[u] != UNNUMBERED) continue;
+            reached[u] = stamp;
+            reach[weight[u]].push_back(u);
+            raised.push_back(u);
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            while (!reach[j].empty()) {
+                const unsigned int y = reach[j].back();
+                reach[j].pop_back();
+
+                for (const unsigned int z : h.neighbors(y)) {
+                    if (number[z] != UNNUMBERED || reached[z] == stamp) continue;
+                    reached[z] = stamp;
+                    if (weight[z] > j) {
+                        reach[weight[z]].push_back(z);
+                        raised.push_back(z);
+                    } else {
+                        reach[j].push_back(z);
+                    }
+                }
+            }
+        }
+
+        for (const unsigned int z : raised) {
+            weight[z]++;
+            madj[z].push_back(v);
+        }
+    }
+}
+
+bool is_clique(const graph& h, const std::vector<unsigned int>& nodes) {
+    for (size_t a = 0; a < nodes.size(); ++a)
+        for (size_t b = a + 1; b < nodes.size(); ++b)
+            if (!h(nodes[a], nodes[b])) return false;
+    return true;
+}
+
+// decomposition of a connected graph h, in the labels of h
+void decompose_connected(const graph& h, atom_decomposition& d) {
+    const size_t n = h.dim;
+
+    std::vector<unsigned int> order;
+    std::vector<std::vector<unsigned int>> madj;
+    mcs_m(h, order, madj);
+
+    // nodes not yet given to an atom
+    std::vector<char> alive(n, 1);
+    size_t left = n;
+
+    std::vector<char> in_separator(n, 0);
+    std::vector<unsigned int> component;
+
+    for (const unsigned int x : order) {
+        if (!alive[x]) continue;
+
+        const auto& s = madj[x];
+        if (std::any_of(s.begin(), s.end(), [&alive](const unsigned int u) { return !alive[u]; })) continue;
+        if (!is_clique(h, s)) continue;
+
+        // component of x once the separator is removed
+        for (const unsigned int u : s) in_separator[u] = 1;
+        component.assign(1, x);
+        alive[x] = 2;
+        for (size_t head = 0; head < component.size(); ++head) {
+            for (const unsigned int u : h.neighbors(component[head])) {
+                if (alive[u] != 1 || in_separator[u]) continue;
+                alive[u] = 2;
+                component.push_back(u);
+            }
+        }
+        for (const unsigned int u : s) in_separator[u] = 0;
+
+        // the separator has to leave something on the other side
+        if (component.size() + s.size() == left) {
+            for (const unsigned int u : component) alive[u] = 1;
+            continue;
+        }
+
+        std::vector<unsigned int> atom(component);
+        atom.insert(atom.end(), s.begin(), s.end());
+        std::sort(atom.begin(), atom.end());
+
+        std::vector<unsigned int> separator(s);
+        std::sort(separator.begin(), separator.end());
+
+        d.atoms.push_back(std::move(atom));
+        d.separators.push_back(std::move(separator));
+
+        for (const unsigned int u : component) alive[u] = 0;
+        left -= component.size();
+    }
+
+    std::vector<unsigned int> last;
+    for (unsigned int u = 0; u < n; ++u)
+        if (alive[u]) last.push_back(u);
+    d.atoms.push_back(std::move(last));
+    d.separators.emplace_back();
+}
+
+}
+
+atom_decomposition decompose_atoms(const graph& g) {
+    atom_decomposition d;
+
+    for (const auto& nodes : connected_components(g)) {
+        const graph h = g.induced_subgraph(nodes);
+
+        // too expensive, or too small to split: the component is one atom
+        const size_t first = d.atoms.size();
+        if (nodes.size() < 3 || nodes.size() * (nodes.size() + h.edges) > ATOMS_MAX_WORK) {
+            d.atoms.emplace_back();
+            d.separators.emplace_back();
+            for (unsigned int v = 0; v < nodes.size(); ++v) d.atoms.back().push_back(v);
+        } else {
+            decompose_connected(h, d);
+        }
+
+        // back to the labels of g (nodes is increasing, so the lists stay sorted)
+        for (size_t i = first; i < d.atoms.size(); ++i) {
+            for (auto& v : d.atoms[i]) v = nodes[v];
+            for (auto& v : d.separators[i]) v = nodes[v];
+        }
+    }
+
+    return d;
+}
+
+unsigned int glue_colorings(const graph& g, const atom_decomposition& d,
+                            const std::vector<std::vector<unsigned int>>& atom_color, std::vector<unsigned int>& color) {
+    color.assign(g.dim, 0);
+    unsigned int colors = 0;
+
+    std::vector<unsigned int> to;
+    std::vector<char> taken;
+
+    for (size_t i = d.atoms.size(); i-- > 0;) {
+        const auto& nodes = d.atoms[i];
+        const auto& own = atom_color[i];
+
+        const unsigned int atom_colors = own.empty() ? 0 : *std::max_element(own.begin(), own.end());
+
+        // the separator is colored already (it belongs to later atoms): its colors fix part of the permutation
+        to.assign(atom_colors + 1, 0);
+        taken.assign(atom_colors + 2, 0);
+        for (size_t v = 0; v < nodes.size(); ++v) {
+            if (color[nodes[v]] == 0) continue;
+            to[own[v]] = color[nodes[v]];
+            if (color[nodes[v]] < taken.size()) taken[color[nodes[v]]] = 1;
+        }
+
+        // the other colors of the atom go to the smallest colors the separator does not use
+        unsigned int next = 1;
+        for (unsigned int c = 1; c <= atom_colors; ++c) {
+            if (to[c] != 0) continue;
+            while (next < taken.size() && taken[next]) next++;
+            to[c] = next++;
+        }
+
+        for (size_t v = 0; v < nodes.size(); ++v) {
+            if (color[nodes[v]] == 0) color[nodes[v]] = to[own[v]];
+            colors = std::max(colors, color[nodes[v]]);
+        }
+    }
+
+    return colors;
+}
@@ -0,0 +1,203 @@
+#include "batch.h"
+#include "graph_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <pthread.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int REQUEST_WORK = 1;
+constexpr int ASSIGN_WORK = 2;
+
+struct dispatcher_state {
+    MPI_Comm comm;                          // dispatch communicator (a duplicate of the batch one)
+    std::vector<int> leaders;               // rank of the leader of each group
+    std::vector<batch_instance> instances;  // heaviest first
+};
+
+// rank 0 only: answers the work requests of the group leaders until every group has been told to stop
+void* dispatcher_thread(void* arg) {
+    dispatcher_state* state = static_cast<dispatcher_state*>(arg);
+
+    const int n_groups = static_cast<int>(state->leaders.size());
+    std::deque<batch_instance> pending(state->instances.begin(), state->instances.end());
+
+    int groups_done = 0;
+    while (groups_done < n_groups) {
+        int group;
+        MPI_Status status;
+        MPI_Recv(&group, 1, MPI_INT, MPI_ANY_SOURCE, REQUEST_WORK, state->comm, &status);
+
+        // an empty path tells the group the batch is over
+        std::string path;
+        if (!pending.empty()) {
+            const bool heavy = group < (n_groups + 1) / 2;
+            path = heavy ? pending.front().path : pending.back().path;
+            if (heavy) pending.pop_front();
+            else pending.pop_back();
+        } else {
+            groups_done++;
+        }
+
+        MPI_Send(path.data(), static_cast<int>(path.size()), MPI_CHAR, status.MPI_SOURCE, ASSIGN_WORK, state->comm);
+    }
+
+    return nullptr;
+}
+
+// group leader only: asks the dispatcher for the next instance
+std::string request_work(const int group, MPI_Comm dispatch_comm) {
+    MPI_Send(&group, 1, MPI_INT, 0, REQUEST_WORK, dispatch_comm);
+
+    MPI_Status status;
+    MPI_Probe(0, ASSIGN_WORK, dispatch_comm, &status);
+
+    int length;
+    MPI_Get_count(&status, MPI_CHAR, &length);
+
+    std::string path(length, '\0');
+    MPI_Recv(path.data(), length, MPI_CHAR, 0, ASSIGN_WORK, dispatch_comm, MPI_STATUS_IGNORE);
+
+    return path;
+}
+
+}
+
+std::vector<batch_instance> list_instances(const std::string& source) {
+    std::vector<batch_instance> instances;
+
+    const auto add = [&instances](const fs::path& path) {
+        std::error_code ec;
+        const auto size = fs::file_size(path, ec);
+        if (ec) {
+            std::cerr << "Warning: skipping " << path.string() << ": " << ec.message() << "\n";
+            return;
+        }
+        instances.push_back({path.string(), static_cast<unsigned long long>(size)});
+    };
+
+    if (fs::is_directory(source)) {
+        for (const auto& entry : fs::directory_iterator(source))
+            if (entry.is_regular_file() && is_instance_file(entry.path())) add(entry.path());
+    } else {
+        std::ifstream list(source);
+        if (!list) throw std::runtime_error("Error: Could not open instance list " + source);
+
+        std::string line;
+        while (std::getline(list, line)) {
+            // trim surrounding blanks (and the '\r' of files edited on Windows)
+            const auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            const auto last = line.find_last_not_of(" \t\r");
+            add(line.substr(first, last - first + 1));
+        }
+    }
+
+    // heaviest first; ties broken by path so every run hands out instances in the same order
+    std::sort(instances.begin(), instances.end(), [](const batch_instance& a, const batch_instance& b) {
+        return a.weight != b.weight ? a.weight > b.weight : a.path < b.path;
+    });
+
+    return instances;
+}
+
+std::vector<int> group_sizes(const int n_processes) {
+    std::vector<int> sizes;
+
+    int left = n_processes;
+    while (left / 2 >= MIN_GROUP_SIZE) {
+        sizes.push_back(left / 2);
+        left -= left / 2;
+    }
+    sizes.push_back(left);
+
+    return sizes;
+}
+
+void run_batch(const std::string& source, MPI_Comm comm, const solver_options& opt) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank); MPI_Comm_size(comm, &size);
+
+    // Step 1: rank 0 lists the instances
+    dispatcher_state state{MPI_COMM_NULL, {}, {}};
+    unsigned long long n_instances = 0;
+    if (rank == 0) {
+        try {
+            state.instances = list_instances(source);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        n_instances = state.instances.size();
+    }
+
+    MPI_Bcast(&n_instances, 1, MPI_UNSIGNED_LONG_LONG, 0, comm);
+    if (n_instances == 0) {
+        if (rank == 0) std::cerr << "No instances found in " << source << std::endl;
+        return;
+    }
+
+    // Step 2: split comm into groups of contiguous ranks
+    const std::vector<int> sizes = group_sizes(size);
+
+    int group = 0, first = 0;
+    while (rank >= first + sizes[group]) first += sizes[group++];
+
+    for (int k = 0, leader = 0; k < static_cast<int>(sizes.size()); leader += sizes[k++])
+        state.leaders.push_back(leader);
+
+    MPI_Comm group_comm;
+    MPI_Comm_split(comm, group, rank, &group_comm);
+
+    int group_rank;
+    MPI_Comm_rank(group_comm, &group_rank);
+
+    // Step 3: rank 0 hands out the instances from a thread of its own, on a private communicator
+    MPI_Comm dispatch_comm;
+    MPI_Comm_dup(comm, &dispatch_comm);
+    state.comm = dispatch_comm;
+
+    pthread_t dispatcher;
+    if (rank == 0) {
+        std::cout << "Batch of " << n_instances << " instances on " << sizes.size() << " groups:";
+        for (const int s : sizes) std::cout << " " << s;
+        std::cout << " processes\n" << std::endl;
+        pthread_create(&dispatcher, nullptr, dispatcher_thread, &state);
+    }
+
+    // Step 4: each group solves one instance at a time until the dispatcher runs out of them
+    while (true) {
+        std::string path;
+        if (group_rank == 0) path = request_work(group, dispatch_comm);
+
+        unsigned long long length = path.size();
+        MPI_Bcast(&length, 1, MPI_UNSIGNED_LONG_LONG, 0, group_comm);
+        if (length == 0) break;
+
+        path.resize(length);
+        MPI_Bcast(path.data(), static_cast<int>(length), MPI_CHAR, 0, group_comm);
+
+        const auto start = std::chrono::steady_clock::now();
+        if (group_rank == 0)
+            std::cout << "Group " << group << " (" << sizes[group] << " processes) solving " << path << std::endl;
+
+        solve_instance(path, group_comm, opt);
+
+        if (group_rank == 0) {
+            const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+            std::cout << "Group " << group << " done with " << path << " in " << duration.count() << " s\n" << std::endl;
+        }
+    }
+
+    if (rank == 0) pthread_join(dispatcher, nullptr);
+
+    MPI_Comm_free(&dispatch_comm);
+    MPI_Comm_free(&group_comm);
+}
@@ -0,0 +1,57 @@
+#include "bound.h"
+
+bool clique_bound::reaches(const solution& s, const unsigned int ub) {
+    if (s.tot_colors >= ub) return true;
+
+    // one color short of ub, the clique has to be colored with the colors used so far: forward checking already
+    // finds the cliques of one or two nodes that cannot, and larger ones are too rare to pay for the bound
+    if (s.tot_colors + 1 == ub) return false;
+
+    const graph& g = *s.ctx->g;
+
+    // the most saturated node, then repeatedly the most saturated uncolored node adjacent to the whole clique
+    clique.assign(1, s.sat.pick());
+    candidates.clear();
+    for (const unsigned int u : g.neighbors(clique[0]))
+        if (s.color[u] == 0) candidates.push_back(u);
+
+    while (!candidates.empty()) {
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); ++i)
+            if (s.sat.saturation(candidates[i]) > s.sat.saturation(candidates[best])) best = i;
+
+        const unsigned int v = candidates[best];
+        clique.push_back(v);
+
+        size_t kept = 0;
+        for (const unsigned int u : candidates)
+            if (u != v && g(u, v)) candidates[kept++] = u;
+        candidates.resize(kept);
+    }
+
+    // the bound reaches ub as long as at most slack nodes of the clique can keep to the colors used so far
+    const unsigned int size = static_cast<unsigned int>(clique.size());
+    if (s.tot_colors + size < ub) return false;
+    const unsigned int slack = s.tot_colors + size - ub;
+
+    matched.assign(s.tot_colors, NONE);
+    unsigned int matching = 0;
+    for (unsigned int i = 0; i < size; ++i) {
+        visited.assign(s.tot_colors, 0);
+        if (augment(s, i) && ++matching > slack) return false;
+    }
+    return true;
+}
+
+bool clique_bound::augment(const solution& s, const unsigned int i) {
+    for (unsigned int c = 1; c <= s.tot_colors; ++c) {
+        if (visited[c - 1] || !s.sat.allowed(clique[i], c)) continue;
+        visited[c - 1] = 1;
+
+        if (matched[c - 1] == NONE || augment(s, matched[c - 1])) {
+            matched[c - 1] = i;
+            return true;
+        }
+    }
+    return false;
+}
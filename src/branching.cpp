@@ -0,0 +1,34 @@
+#include "branching.h"
+
+#include <stdexcept>
+
+node_rule parse_node_rule(const std::string& name) {
+    if (name == "dsatur") return node_rule::dsatur;
+    if (name == "dsatur-degree") return node_rule::dsatur_degree;
+    if (name == "dsatur-free-degree") return node_rule::dsatur_free_degree;
+    if (name == "domain-degree") return node_rule::domain_degree;
+    throw std::runtime_error("Error: Unknown branching rule " + name +
+                             " (expected dsatur, dsatur-degree, dsatur-free-degree or domain-degree)");
+}
+
+value_rule parse_value_rule(const std::string& name) {
+    if (name == "first-fit") return value_rule::first_fit;
+    if (name == "least-constraining") return value_rule::least_constraining;
+    throw std::runtime_error("Error: Unknown value order " + name + " (expected first-fit or least-constraining)");
+}
+
+std::string to_string(const node_rule rule) {
+    switch (rule) {
+        case node_rule::dsatur_degree: return "dsatur-degree";
+        case node_rule::dsatur_free_degree: return "dsatur-free-degree";
+        case node_rule::domain_degree: return "domain-degree";
+        default: return "dsatur";
+    }
+}
+
+std::string to_string(const value_rule rule) {
+    switch (rule) {
+        case value_rule::least_constraining: return "least-constraining";
+        default: return "first-fit";
+    }
+}
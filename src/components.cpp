@@ -0,0 +1,68 @@
+#include "components.h"
+
+#include <algorithm>
+
+std::vector<std::vector<unsigned int>> connected_components(const graph& g) {
+    std::vector<std::vector<unsigned int>> components;
+    std::vector<char> seen(g.dim, 0);
+
+    for (unsigned int s = 0; s < g.dim; ++s) {
+        if (seen[s]) continue;
+
+        // breadth-first search, the component itself is the queue
+        std::vector<unsigned int> component{s};
+        seen[s] = 1;
+        for (size_t head = 0; head < component.size(); ++head) {
+            for (const unsigned int u : g.neighbors(component[head])) {
+                if (seen[u]) continue;
+                seen[u] = 1;
+                component.push_back(u);
+            }
+        }
+
+        std::sort(component.begin(), component.end());
+        components.push_back(std::move(component));
+    }
+
+    std::stable_sort(components.begin(), components.end(), [](const auto& a, const auto& b) {
+        return a.size() < b.size();
+    });
+
+    return components;
+}
+
+unsigned int greedy_coloring(const graph& g, std::vector<unsigned int>& color) {
+    const size_t n = g.dim;
+    color.assign(n, 0);
+
+    // used[v][c] is set if a neighbour of v has color c; saturation[v] counts the distinct ones
+    std::vector<std::vector<char>> used(n);
+    std::vector<unsigned int> saturation(n, 0);
+
+    unsigned int colors = 0;
+    for (size_t step = 0; step < n; ++step) {
+        unsigned int v = static_cast<unsigned int>(n);
+        for (unsigned int u = 0; u < n; ++u) {
+            if (color[u] != 0) continue;
+            if (v == n || saturation[u] > saturation[v] ||
+                (saturation[u] == saturation[v] && g.neighbors(u).size() > g.neighbors(v).size()))
+                v = u;
+        }
+
+        unsigned int c = 1;
+        while (c < used[v].size() && used[v][c]) c++;
+        color[v] = c;
+        colors = std::max(colors, c);
+
+        for (const unsigned int u : g.neighbors(v)) {
+            if (color[u] != 0) continue;
+            if (used[u].size() <= c) used[u].resize(c + 1, 0);
+            if (!used[u][c]) {
+                used[u][c] = 1;
+                saturation[u]++;
+            }
+        }
+    }
+
+    return colors;
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/generator.h"
+
+int main(int argc, char** argv){
+
+  // ----- parse command line ----- //
+
+  std::vector<std::string> args;
+  unsigned long long seed = 1;
+  std::string output;
+
+  try {
+    for (int a = 1; a < argc; ++a) {
+      const std::string arg = argv[a];
+      if (arg == "--seed" && a + 1 < argc) seed = std::stoull(argv[++a]);
+      else if (arg == "--output" && a + 1 < argc) output = argv[++a];
+      else args.push_back(arg);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: Invalid seed." << std::endl;
+    return 1;
+  }
+
+  if (args.empty()) {
+    std::cerr << "Usage:\n./graph-gen [--seed <seed>] [--output <file.col>] <family> <parameters...>\n"
+                 "Families:\n" << generator_usage();
+    return 1;
+  }
+
+  // ----- generate ----- //
+
+  const std::vector<std::string> params(args.begin() + 1, args.end());
+
+  std::string description = args[0];
+  for (const auto& p : params) description += " " + p;
+  description += " --seed " + std::to_string(seed);
+
+  try {
+    const graph g = generate_graph(args[0], params, seed);
+
+    const std::string comment = "generated by graph-gen " + description + "\n" +
+                                std::to_string(g.dim) + " nodes, " + std::to_string(g.edges) + " edges";
+
+    if (output.empty()) {
+      write_dimacs(g, std::cout, comment);
+    } else {
+      std::ofstream out(output);
+      if (!out) throw std::runtime_error("Error: Could not open " + output);
+      write_dimacs(g, out, comment);
+      if (!out.flush()) throw std::runtime_error("Error: Could not write " + output);
+      std::cerr << "Wrote " << output << " (" << g.dim << " nodes, " << g.edges << " edges)" << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,421 @@
+#include "generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+// splitmix64: tiny, fast and fully specified, unlike the std:: distributions
+struct splitmix64 {
+    uint64_t state;
+
+    explicit splitmix64(const uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [0, 1), 53 bits of precision
+    double uniform() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    // uniform in [0, bound), without modulo bias
+    uint64_t below(const uint64_t bound) {
+        const uint64_t limit = -bound % bound;
+        uint64_t x;
+        do { x = next(); } while (x < limit);
+        return x % bound;
+    }
+
+    template <typename T>
+    void shuffle(std::vector<T>& v) {
+        for (size_t i = v.size(); i > 1; --i)
+            std::swap(v[i - 1], v[below(i)]);
+    }
+};
+
+// builds the neighbour lists and counts the distinct edges of a generated graph
+graph finish(graph& g) {
+    g.build_adjacency_lists();
+    g.edges = g.adj.size() / 2;
+    return std::move(g);
+}
+
+// nodes 0 ... n-1 split into k classes of (almost) equal size, in random order
+std::vector<std::vector<unsigned int>> hidden_classes(const size_t n, const unsigned int k, splitmix64& rng) {
+    std::vector<unsigned int> order(n);
+    for (size_t v = 0; v < n; ++v) order[v] = static_cast<unsigned int>(v);
+    rng.shuffle(order);
+
+    std::vector<std::vector<unsigned int>> classes(k);
+    for (size_t pos = 0; pos < n; ++pos)
+        classes[pos % k].push_back(order[pos]);
+
+    return classes;
+}
+
+size_t parse_size(const std::string& s, const std::string& name) {
+    size_t end = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(s, &end);
+    } catch (const std::exception&) {
+        end = 0;
+    }
+    if (end == 0 || end != s.size() || s[0] == '-')
+        throw std::runtime_error("Error: " + name + " must be a non-negative integer, got '" + s + "'");
+    return static_cast<size_t>(value);
+}
+
+double parse_real(const std::string& s, const std::string& name) {
+    size_t end = 0;
+    double value = 0;
+    try {
+        value = std::stod(s, &end);
+    } catch (const std::exception&) {
+        end = 0;
+    }
+    if (end == 0 || end != s.size() || !(value >= 0))
+        throw std::runtime_error("Error: " + name + " must be a non-negative number, got '" + s + "'");
+    return value;
+}
+
+// physical memory of the machine in bytes, 0 if unknown
+size_t physical_memory() {
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGE_SIZE);
+    return pages > 0 && page_size > 0 ? static_cast<size_t>(pages) * static_cast<size_t>(page_size) : 0;
+}
+
+// throws unless a graph of n nodes can be built: its labels fit in an unsigned int, and its adjacency matrix plus
+// scratch_bytes of working space fit in memory
+void check_nodes(const size_t n, const size_t scratch_bytes = 0) {
+    if (n >= std::numeric_limits<unsigned int>::max())
+        throw std::runtime_error("Error: too many nodes (" + std::to_string(n) + ")");
+
+    const size_t max = std::numeric_limits<size_t>::max();
+    const size_t row_bytes = graph::words_per_row(n) * sizeof(graph::word);
+    const size_t memory = physical_memory();
+    if (n != 0 && (row_bytes > max / n || n * row_bytes > max - scratch_bytes ||
+                   (memory != 0 && n * row_bytes + scratch_bytes > memory)))
+        throw std::runtime_error("Error: a graph of " + std::to_string(n) + " nodes does not fit in memory");
+}
+
+}
+
+graph random_graph(const size_t n, const double p, const uint64_t seed) {
+    check_nodes(n);
+
+    graph g;
+    g.resize(n);
+
+    if (p >= 1) {
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = i + 1; j < n; ++j)
+                g.add_edge(i, j);
+    } else if (p > 0) {
+        // walk the pairs (v, w), w < v, in order, jumping straight to the next edge: the gap between two edges is
+        // geometric, so the cost is O(n + edges) instead of one random draw per pair (Batagelj and Brandes)
+        splitmix64 rng(seed);
+        const double log_q = std::log1p(-p);
+
+        size_t v = 1;
+        long long w = -1;
+        while (v < n) {
+            w += 1 + static_cast<long long>(std::floor(std::log1p(-rng.uniform()) / log_q));
+            while (w >= static_cast<long long>(v) && v < n) {
+                w -= static_cast<long long>(v);
+                v++;
+            }
+            if (v < n) g.add_edge(static_cast<unsigned int>(v), static_cast<unsigned int>(w));
+        }
+    }
+
+    return finish(g);
+}
+
+graph queen_graph(const size_t rows, const size_t cols) {
+    check_nodes(rows * cols);
+
+    graph g;
+    g.resize(rows * cols);
+
+    for (size_t r1 = 0; r1 < rows; ++r1) {
+        for (size_t c1 = 0; c1 < cols; ++c1) {
+            const auto u = static_cast<unsigned int>(r1 * cols + c1);
+
+            // only squares after (r1, c1) in row-major order, each pair once
+            for (size_t r2 = r1; r2 < rows; ++r2) {
+                for (size_t c2 = 0; c2 < cols; ++c2) {
+                    if (r2 == r1 && c2 <= c1) continue;
+
+                    const size_t dr = r2 - r1;
+                    const size_t dc = c2 > c1 ? c2 - c1 : c1 - c2;
+                    if (dr == 0 || dc == 0 || dr == dc)
+                        g.add_edge(u, static_cast<unsigned int>(r2 * cols + c2));
+                }
+            }
+        }
+    }
+
+    return finish(g);
+}
+
+graph mycielski_graph(const unsigned int k) {
+    if (k < 1 || k > 30) throw std::runtime_error("Error: Mycielski order must be between 1 and 30");
+
+    // start from K2 and apply the Mycielski construction k - 1 times: node i gets a shadow n + i adjacent to the
+    // neighbours of i, and every shadow is joined to a new apex 2n. Each step takes n to 2n + 1 and the m edges to
+    // 3m + n: the sizes are checked before anything is built
+    size_t final_nodes = 2, final_edges = 1;
+    for (unsigned int step = 1; step < k; ++step) {
+        final_edges = 3 * final_edges + final_nodes;
+        final_nodes = 2 * final_nodes + 1;
+    }
+    using edge = std::pair<unsigned int, unsigned int>;
+    if (final_edges > std::numeric_limits<size_t>::max() / sizeof(edge))
+        throw std::runtime_error("Error: too many edges (" + std::to_string(final_edges) + ")");
+    check_nodes(final_nodes, final_edges * sizeof(edge));
+
+    size_t n = 2;
+    std::vector<edge> edge_list;
+    edge_list.reserve(final_edges);
+    edge_list.emplace_back(0, 1);
+
+    for (unsigned int step = 1; step < k; ++step) {
+        const size_t old_edges = edge_list.size();
+        for (size_t e = 0; e < old_edges; ++e) {
+            const auto [i, j] = edge_list[e];
+            edge_list.emplace_back(i, static_cast<unsigned int>(n + j));
+            edge_list.emplace_back(j, static_cast<unsigned int>(n + i));
+        }
+        for (size_t i = 0; i < n; ++i)
+            edge_list.emplace_back(static_cast<unsigned int>(n + i), static_cast<unsigned int>(2 * n));
+        n = 2 * n + 1;
+    }
+
+    graph g;
+    g.resize(n);
+    for (const auto& [i, j] : edge_list) g.add_edge(i, j);
+
+    return finish(g);
+}
+
+graph leighton_graph(const size_t n, const unsigned int k, const size_t m, const uint64_t seed) {
+    check_nodes(n);
+    if (k < 1 || k > n) throw std::runtime_error("Error: the number of colors must be between 1 and the number of nodes");
+
+    splitmix64 rng(seed);
+    const auto classes = hidden_classes(n, k, rng);
+
+    // pairs of nodes in distinct classes: the most edges a k-coloring allows
+    size_t max_edges = n * (n - 1) / 2;
+    for (const auto& c : classes) max_edges -= c.size() * (c.size() - 1) / 2;
+    if (m > max_edges)
+        throw std::runtime_error("Error: at most " + std::to_string(max_edges) + " edges fit " + std::to_string(k) + " color classes");
+
+    graph g;
+    g.resize(n);
+
+    size_t edges = 0;
+    std::vector<unsigned int> class_ids(k);
+    for (unsigned int c = 0; c < k; ++c) class_ids[c] = c;
+    std::vector<unsigned int> clique;
+
+    // plants a clique on one random node of each of the first size classes of a random class order
+    const auto plant = [&](const unsigned int size) {
+        for (unsigned int s = 0; s < size; ++s)
+            std::swap(class_ids[s], class_ids[s + rng.below(k - s)]);
+
+        clique.clear();
+        for (unsigned int s = 0; s < size; ++s) {
+            const auto& c = classes[class_ids[s]];
+            clique.push_back(c[rng.below(c.size())]);
+        }
+
+        for (unsigned int a = 0; a < size; ++a) {
+            for (unsigned int b = a + 1; b < size; ++b) {
+                if (g(clique[a], clique[b])) continue;
+                g.add_edge(clique[a], clique[b]);
+                edges++;
+            }
+        }
+    };
+
+    // the k-clique certifies the lower bound, the planted coloring the upper bound
+    plant(k);
+    while (edges < m && k > 1)
+        plant(2 + static_cast<unsigned int>(rng.below(k - 1)));
+
+    return finish(g);
+}
+
+graph flat_graph(const size_t n, const unsigned int k, const double p, const uint64_t seed) {
+    check_nodes(n);
+    if (k < 1 || k > n) throw std::runtime_error("Error: the number of colors must be between 1 and the number of nodes");
+    if (p > 1) throw std::runtime_error("Error: the edge probability must be at most 1");
+
+    splitmix64 rng(seed);
+    auto classes = hidden_classes(n, k, rng);
+
+    graph g;
+    g.resize(n);
+
+    for (unsigned int ca = 0; ca < k; ++ca) {
+        for (unsigned int cb = ca + 1; cb < k; ++cb) {
+            // a is the smaller class: round r joins a[i] to b[(i + r) % |b|], a perfect matching of a into b,
+            // and distinct rounds never repeat a pair
+            auto a = classes[ca];
+            auto b = classes[cb];
+            if (a.size() > b.size()) std::swap(a, b);
+            rng.shuffle(a);
+            rng.shuffle(b);
+
+            const auto target = static_cast<size_t>(std::llround(p * static_cast<double>(a.size() * b.size())));
+            const size_t full_rounds = target / a.size();
+            const size_t rest = target % a.size();
+
+            std::vector<size_t> rounds(b.size());
+            for (size_t r = 0; r < rounds.size(); ++r) rounds[r] = r;
+            rng.shuffle(rounds);
+
+            for (size_t t = 0; t < full_rounds; ++t)
+                for (size_t i = 0; i < a.size(); ++i)
+                    g.add_edge(a[i], b[(i + rounds[t]) % b.size()]);
+
+            // a partial round on the first nodes of the (shuffled) smaller class
+            for (size_t i = 0; i < rest; ++i)
+                g.add_edge(a[i], b[(i + rounds[full_rounds]) % b.size()]);
+        }
+    }
+
+    return finish(g);
+}
+
+graph geometric_graph(const size_t n, const double r, const uint64_t seed) {
+    check_nodes(n);
+
+    splitmix64 rng(seed);
+    std::vector<double> x(n), y(n);
+    for (size_t v = 0; v < n; ++v) {
+        x[v] = rng.uniform();
+        y[v] = rng.uniform();
+    }
+
+    graph g;
+    g.resize(n);
+    if (n == 0 || r <= 0) return finish(g);
+
+    // grid of cells at least r wide: neighbours of a point lie in its cell or in the 8 around it
+    const auto cells = static_cast<size_t>(std::max(1.0, std::min(std::floor(1 / r), std::ceil(std::sqrt(static_cast<double>(n))))));
+    const auto cell_of = [cells](const double c) { return std::min(static_cast<size_t>(c * cells), cells - 1); };
+
+    // counting sort of the points by cell
+    std::vector<size_t> start(cells * cells + 1, 0);
+    for (size_t v = 0; v < n; ++v) start[cell_of(y[v]) * cells + cell_of(x[v]) + 1]++;
+    for (size_t c = 0; c < cells * cells; ++c) start[c + 1] += start[c];
+
+    std::vector<unsigned int> points(n);
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (size_t v = 0; v < n; ++v) points[fill[cell_of(y[v]) * cells + cell_of(x[v])]++] = static_cast<unsigned int>(v);
+
+    const double r2 = r * r;
+    const auto close = [&](const unsigned int u, const unsigned int v) {
+        const double dx = x[u] - x[v], dy = y[u] - y[v];
+        return dx * dx + dy * dy <= r2;
+    };
+
+    for (size_t cy = 0; cy < cells; ++cy) {
+        for (size_t cx = 0; cx < cells; ++cx) {
+            const size_t c = cy * cells + cx;
+
+            // pairs inside the cell
+            for (size_t i = start[c]; i < start[c + 1]; ++i)
+                for (size_t j = i + 1; j < start[c + 1]; ++j)
+                    if (close(points[i], points[j])) g.add_edge(points[i], points[j]);
+
+            // pairs with the cells right, below-left, below and below-right, so each pair of cells is seen once
+            const long long offsets[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+            for (const auto& o : offsets) {
+                const long long nx = static_cast<long long>(cx) + o[0];
+                const long long ny = static_cast<long long>(cy) + o[1];
+                if (nx < 0 || ny < 0 || nx >= static_cast<long long>(cells) || ny >= static_cast<long long>(cells)) continue;
+
+                const size_t d = static_cast<size_t>(ny) * cells + static_cast<size_t>(nx);
+                for (size_t i = start[c]; i < start[c + 1]; ++i)
+                    for (size_t j = start[d]; j < start[d + 1]; ++j)
+                        if (close(points[i], points[j])) g.add_edge(points[i], points[j]);
+            }
+        }
+    }
+
+    return finish(g);
+}
+
+graph generate_graph(const std::string& family, const std::vector<std::string>& params, const uint64_t seed) {
+    const auto expect = [&](const size_t count) {
+        if (params.size() != count)
+            throw std::runtime_error("Error: " + family + " takes " + std::to_string(count) + " parameters\n" + generator_usage());
+    };
+
+    if (family == "gnp") {
+        expect(2);
+        return random_graph(parse_size(params[0], "n"), parse_real(params[1], "p"), seed);
+    }
+    if (family == "queen") {
+        if (params.size() == 1) {
+            const size_t side = parse_size(params[0], "n");
+            return queen_graph(side, side);
+        }
+        expect(2);
+        return queen_graph(parse_size(params[0], "rows"), parse_size(params[1], "cols"));
+    }
+    if (family == "mycielski") {
+        expect(1);
+        return mycielski_graph(static_cast<unsigned int>(parse_size(params[0], "k")));
+    }
+    if (family == "leighton") {
+        expect(3);
+        return leighton_graph(parse_size(params[0], "n"), static_cast<unsigned int>(parse_size(params[1], "k")),
+                              parse_size(params[2], "m"), seed);
+    }
+    if (family == "flat") {
+        expect(3);
+        return flat_graph(parse_size(params[0], "n"), static_cast<unsigned int>(parse_size(params[1], "k")),
+                          parse_real(params[2], "p"), seed);
+    }
+    if (family == "geometric") {
+        expect(2);
+        return geometric_graph(parse_size(params[0], "n"), parse_real(params[1], "r"), seed);
+    }
+
+    throw std::runtime_error("Error: unknown graph family '" + family + "'\n" + generator_usage());
+}
+
+std::string generator_usage() {
+    return "  gnp <n> <p>            G(n, p) random graph\n"
+           "  queen <n> [<cols>]     queen graph of an n x n (or n x cols) board\n"
+           "  mycielski <k>          Mycielski graph with chromatic number k + 1 (DIMACS myciel<k>)\n"
+           "  leighton <n> <k> <m>   about m edges, chromatic number exactly k\n"
+           "  flat <n> <k> <p>       flat graph, k-colorable, edge probability p between color classes\n"
+           "  geometric <n> <r>      random points in the unit square, joined within distance r\n";
+}
+
+void write_dimacs(const graph& g, std::ostream& out, const std::string& comment) {
+    std::istringstream lines(comment);
+    std::string line;
+    while (std::getline(lines, line)) out << "c " << line << "\n";
+
+    out << "p edge " << g.dim << " " << g.adj.size() / 2 << "\n";
+    for (unsigned int i = 0; i < g.dim; ++i)
+        for (const unsigned int j : g.neighbors(i))
+            if (j > i) out << "e " << i + 1 << " " << j + 1 << "\n";
+}
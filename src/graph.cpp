@@ -1,65 +1,287 @@
 #include "graph.h"
+#include "mapped_file.h"
 
-size_t graph::dim = -1;
-size_t graph::edges = 0;
+#include <algorithm>
+#include <thread>
+#include <utility>
 
 graph::graph() = default;
 
-graph::graph(const std::string& file_path) {
-    std::ifstream file(file_path);
-    if (!file) {
-        throw std::runtime_error("Error: Unable to open file " + file_path);
+namespace {
+
+// files with a body larger than this are parsed by several threads
+constexpr size_t PARALLEL_PARSE_BYTES = 4 << 20;
+constexpr unsigned int MAX_PARSE_THREADS = 8;
+
+using edge_list = std::vector<std::pair<unsigned int, unsigned int>>;
+
+inline bool is_blank(const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skip_line(const char* p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+// parses an unsigned decimal after optional blanks; returns nullptr if there is no digit
+inline const char* parse_uint(const char* p, const char* end, unsigned int& value) {
+    while (p < end && is_blank(*p)) ++p;
+
+    const char* first = p;
+    unsigned int v = 0;
+    for (unsigned int d; p < end && (d = static_cast<unsigned char>(*p) - '0') < 10; ++p)
+        v = v * 10 + d;
+
+    value = v;
+    return p == first ? nullptr : p;
+}
+
+inline const char* parse_word(const char* p, const char* end, std::string& word) {
+    while (p < end && is_blank(*p)) ++p;
+
+    const char* first = p;
+    while (p < end && !is_blank(*p) && *p != '\n') ++p;
+
+    word.assign(first, p);
+    return p;
+}
+
+// scans the "e u v" records in [p, end) and appends the 0-based edges to out.
+// returns false if an edge references a node outside [1, nodes]
+bool parse_edges(const char* p, const char* end, const unsigned int nodes, edge_list& out) {
+    while (p < end) {
+        while (p < end && is_blank(*p)) ++p;
+
+        if (p < end && *p == 'e') {
+            unsigned int u, v;
+            const char* q = parse_uint(p + 1, end, u);
+            if (q != nullptr) q = parse_uint(q, end, v);
+
+            if (q != nullptr) {
+                if (u == 0 || v == 0 || u > nodes || v > nodes) return false;
+                // self-loops (e.g. in homer.col) carry no constraint a coloring could meet, they are dropped
+                if (u != v) out.emplace_back(u - 1, v - 1);
+                p = q;
+            }
+        }
+
+        // "c" lines, blank lines and anything unknown are skipped
+        p = skip_line(p, end);
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+    return true;
+}
 
-        if (type == "c") {
-            continue;
-        } else if (type == "p") {
-            std::string format;
-            unsigned int nodes, edges;
-            iss >> format >> nodes >> edges;
+// parses the comment lines and the "p edge <nodes> <edges>" line ("p col" is accepted as well), allocates g and returns the first byte after it
+const char* parse_header(graph& g, const char* p, const char* end, const std::string& file_path) {
+    bool found_header = false;
+    while (p < end && !found_header) {
+        while (p < end && is_blank(*p)) ++p;
 
-            graph::dim = nodes;
-            graph::edges = edges;
-            m.resize(graph::dim, std::vector<bool>(graph::dim, false));
+        if (p < end && *p == 'p') {
+            std::string format;
+            unsigned int nodes = 0, edges = 0;
+            const char* q = parse_word(p + 1, end, format);
+            q = parse_uint(q, end, nodes);
+            if (q != nullptr) q = parse_uint(q, end, edges);
 
-            if (format != "edge") {
+            if ((format != "edge" && format != "col") || q == nullptr) {
                 throw std::runtime_error("Error: Dimension mismatch in file");
             }
-        } else if (type == "e") {
-            unsigned int u, v;
-            if (iss >> u >> v) {
-                --u;
-                --v;
-                m[u][v] = true;
-                m[v][u] = true;
+
+            g.resize(nodes);
+            g.edges = edges;
+
+            found_header = true;
+            p = q;
+        } else if (p < end && *p == 'e') {
+            throw std::runtime_error("Error: Edge before problem line in file " + file_path);
+        }
+
+        p = skip_line(p, end);
+    }
+
+    if (!found_header) {
+        throw std::runtime_error("Error: Missing problem line in file " + file_path);
+    }
+
+    return p;
+}
+
+// text DIMACS: header, then one "e u v" record per line
+void parse_text(graph& g, const char* p, const char* end, const std::string& file_path) {
+    p = parse_header(g, p, end, file_path);
+
+    // body: split into line-aligned chunks, one per thread, each collecting its own edge buffer
+    const size_t body = end - p;
+    unsigned int n_threads = 1;
+    if (body > PARALLEL_PARSE_BYTES) {
+        n_threads = std::max(1u, std::min(MAX_PARSE_THREADS, std::thread::hardware_concurrency()));
+    }
+
+    std::vector<const char*> bounds(n_threads + 1, end);
+    bounds[0] = p;
+    for (unsigned int t = 1; t < n_threads; ++t) {
+        const char* cut = std::max(bounds[t - 1], p + body / n_threads * t);
+        bounds[t] = cut == p ? p : skip_line(cut - 1, end);
+    }
+
+    std::vector<edge_list> chunks(n_threads);
+    std::vector<char> chunk_ok(n_threads, 1);
+    const unsigned int nodes = static_cast<unsigned int>(g.dim);
+
+    // each chunk holds about its share of the declared edges
+    for (auto& chunk : chunks) chunk.reserve(g.edges / n_threads + 1);
+
+    if (n_threads == 1) {
+        chunk_ok[0] = parse_edges(bounds[0], bounds[1], nodes, chunks[0]);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < n_threads; ++t) {
+            workers.emplace_back([&, t] {
+                chunk_ok[t] = parse_edges(bounds[t], bounds[t + 1], nodes, chunks[t]);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+
+    // merge the edge buffers into the adjacency matrix
+    for (unsigned int t = 0; t < n_threads; ++t) {
+        if (!chunk_ok[t]) {
+            throw std::runtime_error("Error: Edge endpoint out of range in file " + file_path);
+        }
+        for (const auto& [u, v] : chunks[t]) g.add_edge(u, v);
+    }
+}
+
+// binary DIMACS (.col.b): a line with the preamble length, the textual preamble, then the lower triangle of the
+// adjacency matrix, row i taking (i + 8) / 8 bytes with column j at bit 7 - j % 8 of byte j / 8
+bool is_binary_dimacs(const std::string& file_path, const char* p, const char* end) {
+    if (file_path.size() >= 2 && file_path.compare(file_path.size() - 2, 2, ".b") == 0) return true;
+
+    // magic: the first line holds nothing but the preamble length
+    const char* q = p;
+    while (q < end && *q >= '0' && *q <= '9') ++q;
+    return q != p && q < end && (*q == '\n' || *q == '\r');
+}
+
+void parse_binary(graph& g, const char* p, const char* end, const std::string& file_path) {
+    unsigned int preamble_size = 0;
+    const char* q = parse_uint(p, end, preamble_size);
+    if (q == nullptr) {
+        throw std::runtime_error("Error: Missing preamble size in file " + file_path);
+    }
+    q = skip_line(q, end);
+
+    if (preamble_size > static_cast<size_t>(end - q)) {
+        throw std::runtime_error("Error: Truncated preamble in file " + file_path);
+    }
+    const char* bitmap = q + preamble_size;
+    parse_header(g, q, bitmap, file_path);
+
+    const size_t nodes = g.dim;
+    size_t needed = 0;
+    for (size_t i = 0; i < nodes; ++i) needed += (i + 8) / 8;
+    if (needed > static_cast<size_t>(end - bitmap)) {
+        throw std::runtime_error("Error: Truncated adjacency bitmap in file " + file_path);
+    }
+
+    const auto* row = reinterpret_cast<const unsigned char*>(bitmap);
+    for (size_t i = 0; i < nodes; ++i) {
+        const size_t bytes = (i + 8) / 8;
+        for (size_t k = 0; k < bytes; ++k) {
+            for (unsigned int b = 0; b < 8 && row[k] != 0; ++b) {
+                const size_t j = k * 8 + b;
+                if (j < i && (row[k] & (0x80u >> b))) g.add_edge(i, j);
             }
         }
+        row += bytes;
     }
+}
+
+}
+
+graph::graph(const std::string& file_path) {
+    const mapped_file file(file_path);
+
+    if (is_binary_dimacs(file_path, file.begin(), file.end()))
+        parse_binary(*this, file.begin(), file.end(), file_path);
+    else
+        parse_text(*this, file.begin(), file.end(), file_path);
+
+    build_adjacency_lists();
+}
+
+size_t graph::words_per_row(const size_t d) {
+    // round each row up to a whole number of cache lines
+    const size_t words = (d + word_bits - 1) / word_bits;
+    return (words + line_words - 1) / line_words * line_words;
+}
 
-    file.close();
+void graph::resize(const size_t d) {
+    dim = d;
+    row_words = words_per_row(d);
+    m.assign(d * row_words, 0);
 }
 
-graph::graph(const size_t d, const double density) : m(d, std::vector<bool>(d, false)) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::bernoulli_distribution dist(density); // Probability of an edge
+void graph::build_adjacency_lists() {
+    const size_t n = dim;
 
-    for (unsigned int i = 0; i < dim; ++i) {
-        for (unsigned int j = i + 1; j < dim; ++j) { // Fill only upper triangle
-            bool edge = dist(gen);
-            m[i][j] = edge;
-            m[j][i] = edge; // Symmetric for undirected graph
+    adj_offset.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i)
+        adj_offset[i + 1] = adj_offset[i] + degree(i);
+
+    adj.resize(adj_offset[n]);
+    for (size_t i = 0; i < n; ++i) {
+        // scanning the set bits of the row yields the neighbours already sorted
+        unsigned int* out = adj.data() + adj_offset[i];
+        const word* r = row(i);
+        for (size_t k = 0; k < row_words; ++k) {
+            for (word w = r[k]; w != 0; w &= w - 1)
+                *out++ = k * word_bits + __builtin_ctzll(w);
         }
-        m[i][i] = false; // No self-loops
     }
 }
 
-bool graph::operator()(const unsigned int i, const unsigned int j) const {
-    return m.at(i).at(j);
+graph graph::induced_subgraph(const std::vector<unsigned int>& nodes) const {
+    std::vector<unsigned int> new_label(dim, static_cast<unsigned int>(-1));
+    for (unsigned int v = 0; v < nodes.size(); ++v) new_label[nodes[v]] = v;
+
+    graph sub;
+    sub.resize(nodes.size());
+
+    // each kept edge is met from both ends, so setting one bit per visit fills both halves of the matrix
+    for (unsigned int v = 0; v < nodes.size(); ++v) {
+        word* r = sub.m.data() + v * sub.row_words;
+        for (const unsigned int u : neighbors(nodes[v])) {
+            const unsigned int w = new_label[u];
+            if (w != static_cast<unsigned int>(-1)) r[w / word_bits] |= word(1) << (w % word_bits);
+        }
+    }
+
+    sub.build_adjacency_lists();
+    sub.edges = sub.adj.size() / 2;
+
+    return sub;
+}
+
+size_t graph::degree(const unsigned int i) const {
+    return popcount(row(i), row_words);
+}
+
+size_t graph::common_neighbors(const unsigned int i, const unsigned int j) const {
+    return count_neighbors_in(i, row(j));
+}
+
+size_t graph::count_neighbors_in(const unsigned int i, const word* mask) const {
+    const word* r = row(i);
+    size_t count = 0;
+    for (size_t k = 0; k < row_words; ++k) count += __builtin_popcountll(r[k] & mask[k]);
+    return count;
+}
+
+void graph::intersect_row(const unsigned int i, const word* mask, word* out) const {
+    const word* r = row(i);
+    for (size_t k = 0; k < row_words; ++k) out[k] = r[k] & mask[k];
 }
@@ -0,0 +1,220 @@
+#include "graph_cache.h"
+#include "mapped_file.h"
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+uint64_t fnv1a(const uint32_t* w, const size_t n) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t k = 0; k < n; ++k) {
+        h ^= w[k];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+size_t csr_bytes(const graph& g) {
+    return (g.adj_offset.size() + g.adj.size()) * sizeof(uint32_t);
+}
+
+size_t bitset_bytes(const graph& g) {
+    return g.m.size() * sizeof(graph::word);
+}
+
+}
+
+bool is_instance_file(const fs::path& path) {
+    const std::string name = path.filename().string();
+    const auto ends_with = [&name](const std::string& suffix) {
+        return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return ends_with(".col") || ends_with(".col.b");
+}
+
+std::string graph_cache_path(const std::string& file_path) {
+    return file_path + ".gcb";
+}
+
+bool write_graph_cache(const graph& g, const std::string& cache_path, const uint64_t source_size) {
+    graph_cache_header header{};
+    std::memcpy(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_CACHE_VERSION;
+    header.nodes = g.dim;
+    header.edges = g.edges;
+    header.adj_size = g.adj.size();
+    header.source_size = source_size;
+
+    // pick the smaller of the two encodings
+    std::vector<uint32_t> payload;
+    if (csr_bytes(g) <= bitset_bytes(g)) {
+        header.payload = PAYLOAD_CSR;
+        payload.reserve(g.adj_offset.size() + g.adj.size());
+        payload.insert(payload.end(), g.adj_offset.begin(), g.adj_offset.end());
+        payload.insert(payload.end(), g.adj.begin(), g.adj.end());
+    } else {
+        header.payload = PAYLOAD_BITSET;
+        payload.resize(bitset_bytes(g) / sizeof(uint32_t));
+        std::memcpy(payload.data(), g.m.data(), bitset_bytes(g));
+    }
+    header.payload_bytes = payload.size() * sizeof(uint32_t);
+    header.checksum = fnv1a(payload.data(), payload.size());
+
+    // concurrent jobs may race on the same instance: write aside, then rename over the target
+    const std::string tmp_path = cache_path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(payload.data()), header.payload_bytes);
+        if (!out) {
+            out.close();
+            fs::remove(tmp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, cache_path, ec);
+    if (ec) {
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool read_graph_cache(graph& g, const std::string& cache_path, const uint64_t source_size) {
+    std::error_code ec;
+    if (!fs::is_regular_file(cache_path, ec)) return false;
+
+    const mapped_file file(cache_path);
+    if (file.size < sizeof(graph_cache_header)) return false;
+
+    graph_cache_header header;
+    std::memcpy(&header, file.begin(), sizeof(header));
+
+    if (std::memcmp(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != GRAPH_CACHE_VERSION ||
+        header.source_size != source_size ||
+        header.payload_bytes != file.size - sizeof(header) ||
+        header.payload_bytes % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    // the header is 8-byte sized, so the payload keeps the alignment of the (page aligned) mapping
+    const auto* payload = reinterpret_cast<const uint32_t*>(file.begin() + sizeof(header));
+    const size_t payload_words = header.payload_bytes / sizeof(uint32_t);
+    if (fnv1a(payload, payload_words) != header.checksum) return false;
+
+    // the header is not covered by the checksum: its sizes have to agree with the payload before anything is
+    // allocated from them
+    if (header.nodes > std::numeric_limits<uint32_t>::max()) return false;
+    if (header.payload == PAYLOAD_CSR) {
+        if (header.nodes >= payload_words || header.adj_size >= payload_words ||
+            payload_words != header.nodes + 1 + header.adj_size) return false;
+    } else if (header.payload == PAYLOAD_BITSET) {
+        // nodes rows of row_words 64-bit words, i.e. twice as many payload words
+        const size_t row_words = graph::words_per_row(header.nodes);
+        const size_t row_payload = 2 * row_words;
+        if (header.nodes == 0 ? payload_words != 0
+                              : payload_words % row_payload != 0 || payload_words / row_payload != header.nodes)
+            return false;
+    } else {
+        return false;
+    }
+
+    graph loaded;
+    loaded.resize(header.nodes);
+
+    if (header.payload == PAYLOAD_CSR) {
+        const uint32_t* offsets = payload;
+        const uint32_t* neighbors = payload + header.nodes + 1;
+
+        // every list has to lie within the neighbour array
+        if (offsets[header.nodes] != header.adj_size) return false;
+        for (size_t i = 0; i < header.nodes; ++i)
+            if (offsets[i] > offsets[i + 1]) return false;
+
+        loaded.adj_offset.assign(offsets, offsets + header.nodes + 1);
+        loaded.adj.assign(neighbors, neighbors + header.adj_size);
+
+        // rebuild the matrix rows from the lists
+        for (size_t i = 0; i < header.nodes; ++i) {
+            for (uint32_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                if (neighbors[k] >= header.nodes) return false;
+                graph::word& w = loaded.m[i * loaded.row_words + neighbors[k] / graph::word_bits];
+                w |= graph::word(1) << (neighbors[k] % graph::word_bits);
+            }
+        }
+    } else if (header.payload == PAYLOAD_BITSET) {
+        std::memcpy(loaded.m.data(), payload, header.payload_bytes);
+        loaded.build_adjacency_lists();
+    }
+
+    loaded.edges = header.edges;
+    g = std::move(loaded);
+
+    return true;
+}
+
+graph load_graph(const std::string& file_path, const bool use_cache) {
+    std::error_code ec;
+    const uint64_t source_size = fs::file_size(file_path, ec);
+    if (ec) {
+        throw std::runtime_error("Error: Unable to open file " + file_path);
+    }
+
+    const std::string cache_path = graph_cache_path(file_path);
+
+    if (use_cache) {
+        // a cache older than its source is stale
+        std::error_code source_ec, cache_ec;
+        const auto source_time = fs::last_write_time(file_path, source_ec);
+        const auto cache_time = fs::last_write_time(cache_path, cache_ec);
+
+        graph g;
+        try {
+            if (!source_ec && !cache_ec && cache_time >= source_time && read_graph_cache(g, cache_path, source_size)) return g;
+        } catch (const std::exception&) {
+            // unreadable cache: fall back to the text file
+        }
+    }
+
+    graph g(file_path);
+
+    if (use_cache && !write_graph_cache(g, cache_path, source_size)) {
+        std::cerr << "Warning: could not write graph cache " << cache_path << "\n";
+    }
+
+    return g;
+}
+
+size_t convert_directory(const std::string& dir_path) {
+    size_t converted = 0;
+
+    for (const auto& entry : fs::directory_iterator(dir_path)) {
+        if (!entry.is_regular_file() || !is_instance_file(entry.path())) continue;
+
+        const std::string file_path = entry.path().string();
+        try {
+            const graph g(file_path);
+            if (write_graph_cache(g, graph_cache_path(file_path), entry.file_size())) {
+                std::cout << "Converted " << file_path << " (" << g.dim << " nodes)\n";
+                converted++;
+            } else {
+                std::cerr << "Error: could not write graph cache for " << file_path << "\n";
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+        }
+    }
+
+    return converted;
+}
@@ -0,0 +1,254 @@
+#include "graph_comm.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr int header_dim = 0;
+constexpr int header_edges = 1;
+constexpr int header_format = 2;
+constexpr int header_words = 3;
+
+size_t bitset_wire_words(const size_t n) {
+    return n < 2 ? 0 : (n * (n - 1) / 2 + 31) / 32;
+}
+
+size_t csr_wire_words(const graph& g, const size_t n) {
+    // every undirected edge is listed once, from its smaller endpoint
+    return n + g.adj.size() / 2;
+}
+
+// position of the pair (i, j), i < j, in the row-major strict upper triangle of an n x n matrix
+size_t triangle_index(const size_t i, const size_t j, const size_t n) {
+    return i * (n - 1) - i * (i - 1) / 2 + (j - i - 1);
+}
+
+std::vector<uint32_t> encode(const graph& g, const size_t n, const unsigned int format) {
+    std::vector<uint32_t> payload;
+
+    if (format == WIRE_BITSET) {
+        payload.assign(bitset_wire_words(n), 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (const unsigned int j : g.neighbors(i)) {
+                if (j <= i) continue;
+                const size_t t = triangle_index(i, j, n);
+                payload[t / 32] |= uint32_t(1) << (t % 32);
+            }
+        }
+    } else {
+        payload.reserve(csr_wire_words(g, n));
+        for (size_t i = 0; i < n; ++i) {
+            const auto nb = g.neighbors(i);
+            const unsigned int* upper = std::upper_bound(nb.begin(), nb.end(), static_cast<unsigned int>(i));
+            payload.push_back(static_cast<uint32_t>(nb.end() - upper));
+            payload.insert(payload.end(), upper, nb.end());
+        }
+    }
+
+    return payload;
+}
+
+// rebuilds the adjacency matrix from consecutive chunks of the wire payload
+struct decoder {
+    graph& g;
+    const size_t n;
+    const unsigned int format;
+
+    // WIRE_BITSET: pair (i, j) the next bit refers to
+    size_t i = 0;
+    size_t j = 1;
+
+    // WIRE_CSR: current row and number of its neighbours still to be read (-1: next word is a count)
+    size_t row = 0;
+    int64_t remaining = -1;
+
+    // moves the (i, j) cursor k pairs forward
+    void advance(size_t k) {
+        while (k > 0 && i < n) {
+            const size_t left_in_row = n - j;
+            if (k < left_in_row) {
+                j += k;
+                return;
+            }
+            k -= left_in_row;
+            ++i;
+            j = i + 1;
+        }
+    }
+
+    void feed(const uint32_t* words, const size_t count) {
+        if (format == WIRE_BITSET) {
+            for (size_t w = 0; w < count; ++w) {
+                unsigned int pos = 0;
+                for (uint32_t bits = words[w]; bits != 0; bits &= bits - 1) {
+                    const unsigned int b = __builtin_ctz(bits);
+                    advance(b - pos);
+                    pos = b;
+                    g.add_edge(i, j);
+                }
+                advance(32 - pos);
+            }
+        } else {
+            for (size_t w = 0; w < count; ++w) {
+                if (remaining < 0) {
+                    remaining = words[w];
+                } else {
+                    g.add_edge(row, words[w]);
+                    --remaining;
+                }
+                // rows are closed as soon as their last neighbour (or an empty count) is read
+                if (remaining == 0) {
+                    ++row;
+                    remaining = -1;
+                }
+            }
+        }
+    }
+};
+
+}
+
+void broadcast_graph(graph &g, const int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Step 1: root picks the smaller wire encoding and broadcasts the header
+    std::vector<uint32_t> payload;
+    unsigned long long header[4];
+
+    if (rank == root) {
+        const size_t n = g.dim;
+        const unsigned int format = bitset_wire_words(n) <= csr_wire_words(g, n) ? WIRE_BITSET : WIRE_CSR;
+        payload = encode(g, n, format);
+
+        header[header_dim] = n;
+        header[header_edges] = g.edges;
+        header[header_format] = format;
+        header[header_words] = payload.size();
+    }
+
+    MPI_Bcast(header, 4, MPI_UNSIGNED_LONG_LONG, root, comm);
+
+    if (rank != root) {
+        g.resize(header[header_dim]);
+        g.edges = header[header_edges];
+    }
+
+    // Step 2: pipeline the payload in chunks; receivers decode chunk k while chunk k + 1 is in flight
+    const size_t total = header[header_words];
+    const size_t n_chunks = (total + BROADCAST_CHUNK_WORDS - 1) / BROADCAST_CHUNK_WORDS;
+
+    decoder dec{g, g.dim, static_cast<unsigned int>(header[header_format])};
+    std::vector<uint32_t> buffers[2];
+    if (rank != root) {
+        buffers[0].resize(std::min(total, BROADCAST_CHUNK_WORDS));
+        buffers[1].resize(std::min(total, BROADCAST_CHUNK_WORDS));
+    }
+
+    const auto chunk_data = [&](const size_t k) {
+        return rank == root ? payload.data() + k * BROADCAST_CHUNK_WORDS : buffers[k % 2].data();
+    };
+    const auto chunk_size = [&](const size_t k) {
+        return std::min(BROADCAST_CHUNK_WORDS, total - k * BROADCAST_CHUNK_WORDS);
+    };
+
+    MPI_Request request[2];
+    if (n_chunks > 0) {
+        MPI_Ibcast(chunk_data(0), chunk_size(0), MPI_UINT32_T, root, comm, &request[0]);
+    }
+
+    for (size_t k = 0; k < n_chunks; ++k) {
+        if (k + 1 < n_chunks) {
+            MPI_Ibcast(chunk_data(k + 1), chunk_size(k + 1), MPI_UINT32_T, root, comm, &request[(k + 1) % 2]);
+        }
+
+        MPI_Wait(&request[k % 2], MPI_STATUS_IGNORE);
+
+        if (rank != root) dec.feed(chunk_data(k), chunk_size(k));
+    }
+
+    // Step 3: Rebuild the neighbour lists locally
+    if (rank != root) g.build_adjacency_lists();
+}
+
+namespace {
+
+// window sections start on a cache line
+size_t align_up(const size_t bytes) {
+    return (bytes + 63) / 64 * 64;
+}
+
+}
+
+shared_graph_window share_graph(graph &g, const int root, MPI_Comm comm) {
+    shared_graph_window w;
+
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Step 1: split comm by node; sorting root first makes it node rank 0 and leaders rank 0
+    const int key = rank == root ? 0 : rank + 1;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &w.node_comm);
+
+    int node_rank;
+    MPI_Comm_rank(w.node_comm, &node_rank);
+    MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, key, &w.leaders);
+
+    // Step 2: one copy per node travels over the network
+    if (node_rank == 0) broadcast_graph(g, 0, w.leaders);
+
+    // Step 3: leaders tell their node how large the graph is
+    unsigned long long sizes[5];
+    if (node_rank == 0) {
+        sizes[0] = g.dim;
+        sizes[1] = g.edges;
+        sizes[2] = g.m.size();
+        sizes[3] = g.adj_offset.size();
+        sizes[4] = g.adj.size();
+    }
+    MPI_Bcast(sizes, 5, MPI_UNSIGNED_LONG_LONG, 0, w.node_comm);
+
+
+    const size_t m_bytes = align_up(sizes[2] * sizeof(graph::word));
+    const size_t offset_bytes = align_up(sizes[3] * sizeof(unsigned int));
+    const size_t adj_bytes = align_up(sizes[4] * sizeof(unsigned int));
+
+    // Step 4: the leader allocates the whole segment, the others attach to it
+    void* local_base;
+    const MPI_Aint local_size = node_rank == 0 ? m_bytes + offset_bytes + adj_bytes : 0;
+    MPI_Win_allocate_shared(local_size, 1, MPI_INFO_NULL, w.node_comm, &local_base, &w.win);
+
+    MPI_Aint segment_size;
+    int disp_unit;
+    char* base;
+    MPI_Win_shared_query(w.win, 0, &segment_size, &disp_unit, &base);
+
+    auto* m_ptr = reinterpret_cast<graph::word*>(base);
+    auto* offset_ptr = reinterpret_cast<unsigned int*>(base + m_bytes);
+    auto* adj_ptr = reinterpret_cast<unsigned int*>(base + m_bytes + offset_bytes);
+
+    MPI_Win_fence(0, w.win);
+    if (node_rank == 0) {
+        std::copy(g.m.begin(), g.m.end(), m_ptr);
+        std::copy(g.adj_offset.begin(), g.adj_offset.end(), offset_ptr);
+        std::copy(g.adj.begin(), g.adj.end(), adj_ptr);
+    }
+    MPI_Win_fence(0, w.win);
+
+    // Step 5: drop private copies and view the shared one
+    g.dim = sizes[0];
+    g.edges = sizes[1];
+    g.row_words = graph::words_per_row(sizes[0]);
+    g.m.view(m_ptr, sizes[2]);
+    g.adj_offset.view(offset_ptr, sizes[3]);
+    g.adj.view(adj_ptr, sizes[4]);
+
+    return w;
+}
+
+void free_shared_graph(shared_graph_window &w) {
+    if (w.win != MPI_WIN_NULL) MPI_Win_free(&w.win);
+    if (w.leaders != MPI_COMM_NULL) MPI_Comm_free(&w.leaders);
+    if (w.node_comm != MPI_COMM_NULL) MPI_Comm_free(&w.node_comm);
+}
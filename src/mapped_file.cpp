@@ -0,0 +1,42 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+mapped_file::mapped_file(const std::string& file_path) {
+    const int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Error: Unable to open file " + file_path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Error: Unable to stat file " + file_path);
+    }
+
+    size = static_cast<size_t>(info.st_size);
+
+    // mmap refuses zero-length mappings, an empty file is just an empty range
+    if (size > 0) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Error: Unable to map file " + file_path);
+        }
+        data = static_cast<const char*>(addr);
+
+        // the file is read front to back, once
+        madvise(addr, size, MADV_SEQUENTIAL);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+mapped_file::~mapped_file() {
+    if (data != nullptr) munmap(const_cast<char*>(data), size);
+}
@@ -1,4 +1,5 @@
 #include "../include/maxclique.h"
+#include <algorithm>
 #include <vector>
 #include <omp.h>
 
@@ -7,19 +8,26 @@
 
 // Recursive Bron-Kerbosch function with pivoting and pruning
 // R: current clique, P: candidates, X: already considered
-// 'max_clique' is updated in critical section
+// 'max_clique' and its nodes 'witness' are updated in critical section
 void bronKerbosch(const std::vector<int>& R,
                   const std::vector<int>& P,
                   const std::vector<int>& X,
                   const graph &g,
                   int &max_clique,
-                  int depth) {
+                  std::vector<int> &witness,
+                  int depth,
+                  const std::atomic<bool> &stop) {
+    // Give up: max_clique still holds a clique, i.e. a valid lower bound
+    if (stop) return;
+
     // If P and X are empty, R is a max clique
     if (P.empty() && X.empty()) {
         #pragma omp critical
         {
-            if (R.size() > static_cast<size_t>(max_clique))
+            if (R.size() > static_cast<size_t>(max_clique)) {
                 max_clique = R.size();
+                witness = R;
+            }
         }
         return;
     }
@@ -63,28 +71,67 @@ void bronKerbosch(const std::vector<int>& R,
         if (depth < TASK_DEPTH_THRESHOLD) {
             #pragma omp task firstprivate(newR, newP, newX, depth)
             {
-                bronKerbosch(newR, newP, newX, g, max_clique, depth + 1);
+                bronKerbosch(newR, newP, newX, g, max_clique, witness, depth + 1, stop);
             }
         } else {
-            bronKerbosch(newR, newP, newX, g, max_clique, depth + 1);
+            bronKerbosch(newR, newP, newX, g, max_clique, witness, depth + 1, stop);
         }
     }
     #pragma omp taskwait
 }
 
-int find_max_clique(const graph &g) {
+std::vector<unsigned int> find_max_clique(const graph &g, const std::atomic<bool> &stop) {
     int max_clique = 0;
+    std::vector<int> witness;
     std::vector<int> R, P, X;
     // Inizialize P with all vertices [0, dim-1]
-    for (int i = 0; i < static_cast<int>(graph::dim); i++) {
+    for (int i = 0; i < static_cast<int>(g.dim); i++) {
         P.push_back(i);
     }
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
-            bronKerbosch(R, P, X, g, max_clique, 0);
+            bronKerbosch(R, P, X, g, max_clique, witness, 0, stop);
+        }
+    }
+    return std::vector<unsigned int>(witness.begin(), witness.end());
+}
+
+std::vector<unsigned int> greedy_clique(const graph &g) {
+    std::vector<unsigned int> best;
+    if (g.dim > 0) best.push_back(0);
+
+    std::vector<size_t> degree(g.dim);
+    for (unsigned int v = 0; v < g.dim; ++v) degree[v] = g.neighbors(v).size();
+
+    std::vector<graph::word> candidates(g.row_words);
+    std::vector<unsigned int> clique;
+    for (unsigned int v = 0; v < g.dim; ++v) {
+        // a clique through v has at most degree(v) + 1 nodes
+        if (degree[v] + 1 <= best.size()) continue;
+
+        std::copy(g.row(v), g.row(v) + g.row_words, candidates.begin());
+        clique.assign(1, v);
+
+        while (true) {
+            // candidate of largest degree
+            unsigned int pick = g.dim;
+            for (size_t k = 0; k < g.row_words; ++k) {
+                for (graph::word w = candidates[k]; w != 0; w &= w - 1) {
+                    const unsigned int u = k * graph::word_bits + __builtin_ctzll(w);
+                    if (pick == g.dim || degree[u] > degree[pick]) pick = u;
+                }
+            }
+            if (pick == g.dim) break;
+
+            clique.push_back(pick);
+            g.intersect_row(pick, candidates.data(), candidates.data());
+            candidates[pick / graph::word_bits] &= ~(graph::word(1) << (pick % graph::word_bits));
         }
+
+        if (clique.size() > best.size()) best = clique;
     }
-    return max_clique;
+
+    return best;
 }
@@ -0,0 +1,158 @@
+#include "reduce.h"
+
+#include <algorithm>
+
+namespace {
+
+// the state of the graph while nodes are peeled off
+struct peeling {
+    const graph& g;
+    unsigned int lower_bound;
+
+    // alive nodes, as a flag per node and as a bitset to mask adjacency rows with
+    std::vector<char> alive;
+    std::vector<graph::word> alive_mask;
+
+    // degree among the alive nodes
+    std::vector<unsigned int> deg;
+
+    // nodes whose degree dropped below lower_bound, waiting to be removed
+    std::vector<unsigned int> low;
+
+    reduction& r;
+
+    peeling(const graph& g, const unsigned int lower_bound, reduction& r)
+        : g(g), lower_bound(lower_bound), alive(g.dim, 1), alive_mask(g.row_words, 0), deg(g.dim), r(r) {
+        for (unsigned int v = 0; v < g.dim; ++v) {
+            alive_mask[v / graph::word_bits] |= graph::word(1) << (v % graph::word_bits);
+            deg[v] = static_cast<unsigned int>(g.neighbors(v).size());
+            if (deg[v] < lower_bound) low.push_back(v);
+        }
+    }
+
+    void remove(const unsigned int v, const unsigned int dominator) {
+        alive[v] = 0;
+        alive_mask[v / graph::word_bits] &= ~(graph::word(1) << (v % graph::word_bits));
+
+        r.removed.push_back(v);
+        r.dominator.push_back(dominator);
+
+        for (const unsigned int w : g.neighbors(v)) {
+            if (!alive[w]) continue;
+            // queue w the moment it crosses the threshold, so it is queued once
+            if (deg[w]-- == lower_bound) low.push_back(w);
+        }
+    }
+
+    // alive node v, not adjacent to u, whose alive neighbours include all those of u; g.dim if there is none
+    unsigned int find_dominator(const unsigned int u) const {
+        // an isolated node is dominated by any other node
+        if (deg[u] == 0) {
+            for (unsigned int v = 0; v < g.dim; ++v)
+                if (alive[v] && v != u) return v;
+            return g.dim;
+        }
+
+        // a dominator is adjacent to every neighbour of u: look among the neighbours of the one of smallest degree
+        unsigned int pivot = g.dim;
+        for (const unsigned int w : g.neighbors(u))
+            if (alive[w] && (pivot == g.dim || deg[w] < deg[pivot])) pivot = w;
+
+        const graph::word* row_u = g.row(u);
+        for (const unsigned int v : g.neighbors(pivot)) {
+            if (v == u || !alive[v] || deg[v] < deg[u] || g(u, v)) continue;
+
+            // N(u) \ N(v) restricted to the alive nodes must be empty
+            const graph::word* row_v = g.row(v);
+            bool contained = true;
+            for (size_t k = 0; k < g.row_words && contained; ++k)
+                contained = (row_u[k] & alive_mask[k] & ~row_v[k]) == 0;
+
+            if (contained) return v;
+        }
+
+        return g.dim;
+    }
+};
+
+}
+
+reduction reduce_graph(const graph& g, const unsigned int lower_bound) {
+    reduction r;
+    r.lower_bound = lower_bound;
+
+    peeling p(g, lower_bound, r);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        // degree rule, until no node is left below the bound
+        while (!p.low.empty()) {
+            const unsigned int v = p.low.back();
+            p.low.pop_back();
+            if (!p.alive[v]) continue;
+
+            p.remove(v, NO_DOMINATOR);
+            r.low_degree++;
+        }
+
+        // domination rule, one sweep; any removal may enable the degree rule again
+        for (unsigned int u = 0; u < g.dim; ++u) {
+            if (!p.alive[u]) continue;
+
+            const unsigned int v = p.find_dominator(u);
+            if (v == g.dim) continue;
+
+            p.remove(u, v);
+            r.dominated++;
+            changed = true;
+        }
+
+        changed = changed || !p.low.empty();
+    }
+
+    for (unsigned int v = 0; v < g.dim; ++v)
+        if (p.alive[v]) r.kernel_nodes.push_back(v);
+
+    return r;
+}
+
+unsigned int extend_coloring(const graph& g, const reduction& r, const std::vector<unsigned int>& kernel_color,
+                             std::vector<unsigned int>& color) {
+    color.assign(g.dim, 0);
+    for (size_t v = 0; v < r.kernel_nodes.size(); ++v)
+        color[r.kernel_nodes[v]] = kernel_color[v];
+
+    // in reverse removal order, the colored neighbours of a node are the ones it had when it was removed
+    std::vector<char> used;
+    for (size_t k = r.removed.size(); k-- > 0;) {
+        const unsigned int v = r.removed[k];
+
+        if (r.dominator[k] != NO_DOMINATOR) {
+            color[v] = color[r.dominator[k]];
+            continue;
+        }
+
+        // smallest color no neighbour has: at most lower_bound, since fewer than lower_bound neighbours are colored
+        used.assign(g.neighbors(v).size() + 2, 0);
+        for (const unsigned int w : g.neighbors(v))
+            if (color[w] < used.size()) used[color[w]] = 1;
+
+        unsigned int c = 1;
+        while (used[c]) c++;
+        color[v] = c;
+    }
+
+    if (g.dim == 0) return 0;
+
+    // renumber the colors in order of first use, so they are 1 ... k without gaps
+    std::vector<unsigned int> renumber(*std::max_element(color.begin(), color.end()) + 1, 0);
+    unsigned int colors = 0;
+    for (auto& c : color) {
+        if (renumber[c] == 0) renumber[c] = ++colors;
+        c = renumber[c];
+    }
+
+    return colors;
+}
@@ -0,0 +1,212 @@
+#include "reorder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+std::vector<unsigned int> degrees(const graph& g) {
+    std::vector<unsigned int> deg(g.dim);
+    for (unsigned int v = 0; v < g.dim; ++v) deg[v] = static_cast<unsigned int>(g.neighbors(v).size());
+    return deg;
+}
+
+// smallest-last order in O(n + m) (Batagelj and Zaversnik): nodes bucketed by current degree, the node of
+// smallest degree is removed next and its neighbours move down one bucket
+std::vector<unsigned int> degeneracy_order(const graph& g) {
+    const size_t n = g.dim;
+    std::vector<unsigned int> deg = degrees(g);
+
+    const unsigned int max_deg = n == 0 ? 0 : *std::max_element(deg.begin(), deg.end());
+
+    // bin[d] = first position of the nodes of degree d in vert
+    std::vector<unsigned int> bin(max_deg + 2, 0);
+    for (unsigned int v = 0; v < n; ++v) bin[deg[v] + 1]++;
+    for (unsigned int d = 0; d <= max_deg; ++d) bin[d + 1] += bin[d];
+
+    std::vector<unsigned int> vert(n), pos(n);
+    std::vector<unsigned int> fill(bin.begin(), bin.end() - 1);
+    for (unsigned int v = 0; v < n; ++v) {
+        pos[v] = fill[deg[v]]++;
+        vert[pos[v]] = v;
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        const unsigned int v = vert[i];
+        for (const unsigned int u : g.neighbors(v)) {
+            if (deg[u] <= deg[v]) continue;
+
+            // move u to the front of its bucket, then shrink the bucket by one
+            const unsigned int du = deg[u];
+            const unsigned int pw = bin[du];
+            const unsigned int w = vert[pw];
+            if (u != w) {
+                std::swap(vert[pos[u]], vert[pw]);
+                std::swap(pos[u], pos[w]);
+            }
+            bin[du]++;
+            deg[u]--;
+        }
+    }
+
+    // vert is the removal order: the last nodes removed form the densest core
+    std::reverse(vert.begin(), vert.end());
+    return vert;
+}
+
+// breadth-first search from start; returns the nodes of its component in visit order and sets their depth.
+// A node is seen by this search if seen[node] == stamp, so no per-search reset is needed
+std::vector<unsigned int> bfs(const graph& g, const unsigned int start, std::vector<unsigned int>& seen,
+                              const unsigned int stamp, std::vector<unsigned int>& depth,
+                              const std::vector<unsigned int>& deg) {
+    std::vector<unsigned int> order{start};
+    seen[start] = stamp;
+    depth[start] = 0;
+
+    std::vector<unsigned int> next;
+    for (size_t head = 0; head < order.size(); ++head) {
+        const unsigned int v = order[head];
+
+        // neighbours in increasing degree, as Cuthill-McKee prescribes
+        next.clear();
+        for (const unsigned int u : g.neighbors(v))
+            if (seen[u] != stamp) next.push_back(u);
+        std::sort(next.begin(), next.end(), [&deg](const unsigned int a, const unsigned int b) {
+            return deg[a] != deg[b] ? deg[a] < deg[b] : a < b;
+        });
+
+        for (const unsigned int u : next) {
+            seen[u] = stamp;
+            depth[u] = depth[v] + 1;
+            order.push_back(u);
+        }
+    }
+
+    return order;
+}
+
+// reverse Cuthill-McKee, one component at a time, each started from a pseudo-peripheral node
+std::vector<unsigned int> rcm_order(const graph& g) {
+    const size_t n = g.dim;
+    const std::vector<unsigned int> deg = degrees(g);
+
+    std::vector<unsigned int> by_degree(n);
+    for (unsigned int v = 0; v < n; ++v) by_degree[v] = v;
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&deg](const unsigned int a, const unsigned int b) {
+        return deg[a] < deg[b];
+    });
+
+    std::vector<char> visited(n, 0);
+    std::vector<unsigned int> seen(n, 0), depth(n, 0);
+    unsigned int stamp = 0;
+    std::vector<unsigned int> result;
+    result.reserve(n);
+
+    for (const unsigned int seed : by_degree) {
+        if (visited[seed]) continue;
+
+        // pseudo-peripheral node: restart from the smallest-degree node of the deepest level while the depth grows
+        std::vector<unsigned int> order = bfs(g, seed, seen, ++stamp, depth, deg);
+        for (int round = 0; round < 8; ++round) {
+            const unsigned int eccentricity = depth[order.back()];
+            unsigned int candidate = order.back();
+            for (auto it = order.rbegin(); it != order.rend() && depth[*it] == eccentricity; ++it)
+                if (deg[*it] < deg[candidate]) candidate = *it;
+
+            std::vector<unsigned int> candidate_order = bfs(g, candidate, seen, ++stamp, depth, deg);
+            if (depth[candidate_order.back()] <= eccentricity) break;
+            order = std::move(candidate_order);
+        }
+
+        for (const unsigned int v : order) visited[v] = 1;
+        result.insert(result.end(), order.begin(), order.end());
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+std::vector<unsigned int> degree_order(const graph& g) {
+    const std::vector<unsigned int> deg = degrees(g);
+
+    std::vector<unsigned int> order(g.dim);
+    for (unsigned int v = 0; v < g.dim; ++v) order[v] = v;
+    std::stable_sort(order.begin(), order.end(), [&deg](const unsigned int a, const unsigned int b) {
+        return deg[a] > deg[b];
+    });
+
+    return order;
+}
+
+}
+
+vertex_order parse_vertex_order(const std::string& name) {
+    if (name == "none") return vertex_order::none;
+    if (name == "degeneracy") return vertex_order::degeneracy;
+    if (name == "rcm") return vertex_order::rcm;
+    if (name == "degree") return vertex_order::degree;
+    throw std::runtime_error("Error: unknown vertex order '" + name + "' (none, degeneracy, rcm, degree)");
+}
+
+std::string to_string(const vertex_order order) {
+    switch (order) {
+        case vertex_order::degeneracy: return "degeneracy";
+        case vertex_order::rcm: return "rcm";
+        case vertex_order::degree: return "degree";
+        default: return "none";
+    }
+}
+
+std::vector<unsigned int> compute_order(const graph& g, const vertex_order order) {
+    switch (order) {
+        case vertex_order::degeneracy: return degeneracy_order(g);
+        case vertex_order::rcm: return rcm_order(g);
+        case vertex_order::degree: return degree_order(g);
+        default: {
+            std::vector<unsigned int> identity(g.dim);
+            for (unsigned int v = 0; v < g.dim; ++v) identity[v] = v;
+            return identity;
+        }
+    }
+}
+
+graph permute_graph(const graph& g, const std::vector<unsigned int>& order) {
+    const size_t n = g.dim;
+
+    std::vector<unsigned int> new_label(n);
+    for (unsigned int v = 0; v < n; ++v) new_label[order[v]] = v;
+
+    graph p;
+    p.resize(n);
+    p.edges = g.edges;
+
+    // row v of the new matrix is row order[v] of the old one, relabelled; the symmetric bit is set when the
+    // neighbour's own row is written
+    for (unsigned int v = 0; v < n; ++v) {
+        graph::word* row = p.m.data() + v * p.row_words;
+        for (const unsigned int u : g.neighbors(order[v])) {
+            const unsigned int w = new_label[u];
+            row[w / graph::word_bits] |= graph::word(1) << (w % graph::word_bits);
+        }
+    }
+
+    p.build_adjacency_lists();
+
+    p.original_id.resize(n);
+    for (unsigned int v = 0; v < n; ++v)
+        p.original_id[v] = g.original_id.empty() ? order[v] : g.original_id[order[v]];
+
+    return p;
+}
+
+size_t bandwidth(const graph& g) {
+    size_t band = 0;
+    for (unsigned int v = 0; v < g.dim; ++v) {
+        const auto nb = g.neighbors(v);
+        // lists are sorted: the farthest neighbour is at one end
+        if (nb.size() == 0) continue;
+        band = std::max<size_t>(band, std::max(v > nb.first[0] ? v - nb.first[0] : nb.first[0] - v,
+                                               nb.last[-1] > v ? nb.last[-1] - v : v - nb.last[-1]));
+    }
+    return band;
+}
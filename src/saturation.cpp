@@ -0,0 +1,74 @@
+#include "saturation.h"
+
+void saturation_state::reset(const graph& g, const std::vector<unsigned int>& color) {
+    n = static_cast<unsigned int>(g.dim);
+    colors = 0;
+    count.clear();
+    first.clear();
+    sat.assign(n, 0);
+    free_deg.resize(n);
+    for (unsigned int v = 0; v < n; ++v) free_deg[v] = static_cast<unsigned int>(g.neighbors(v).size());
+    head.assign(n + 1, NONE);
+    prev.assign(n, NONE);
+    next.assign(n, NONE);
+    colored.assign(n, 0);
+    top = 0;
+
+    for (unsigned int v = 0; v < n; ++v) insert(v);
+    for (unsigned int v = 0; v < n; ++v)
+        if (color[v] != 0) assign(g, v, color[v]);
+}
+
+void saturation_state::assign(const graph& g, const unsigned int v, const unsigned int c) {
+    if (c > colors) {
+        count.resize(static_cast<size_t>(c) * n, 0);
+        first.resize(static_cast<size_t>(c) * n, 0);
+        colors = c;
+    }
+
+    erase(v);
+    colored[v] = 1;
+    for (const unsigned int u : g.neighbors(v)) {
+        free_deg[u]--;
+        update(u, c, v, true);
+    }
+}
+
+void saturation_state::unassign(const graph& g, const unsigned int v, const unsigned int c) {
+    for (const unsigned int u : g.neighbors(v)) {
+        free_deg[u]++;
+        update(u, c, v, false);
+    }
+    colored[v] = 0;
+    insert(v);
+}
+
+void saturation_state::insert(const unsigned int v) {
+    const unsigned int s = sat[v];
+    prev[v] = NONE;
+    next[v] = head[s];
+    if (head[s] != NONE) prev[head[s]] = v;
+    head[s] = v;
+    if (s > top) top = s;
+}
+
+void saturation_state::erase(const unsigned int v) {
+    if (prev[v] != NONE) next[prev[v]] = next[v];
+    else head[sat[v]] = next[v];
+    if (next[v] != NONE) prev[next[v]] = prev[v];
+}
+
+void saturation_state::update(const unsigned int u, const unsigned int c, const unsigned int v, const bool up) {
+    const size_t i = static_cast<size_t>(c - 1) * n + u;
+    unsigned int& k = count[i];
+
+    // the saturation of u only changes when c appears around it or disappears
+    const bool changes = up ? k++ == 0 : --k == 0;
+    if (!changes) return;
+    if (up) first[i] = v;
+
+    if (!colored[u]) erase(u);
+    if (up) sat[u]++;
+    else sat[u]--;
+    if (!colored[u]) insert(u);
+}
@@ -0,0 +1,346 @@
+#include "search.h"
+#include "work_pool.h"
+
+
+template <typename Node, typename Value>
+search_engine<Node, Value>::search_engine(context& ctx, const solution& start, work_pool* pool,
+                                          const unsigned int thread)
+    : ctx(ctx), cur(start), pool(pool), thread(thread), words(ctx.dim / 64 + 1),
+      reason(ctx.dim * words, 0), explained(ctx.dim, 1), stamp(ctx.dim, 0) {
+}
+
+template <typename Node, typename Value>
+bool search_engine<Node, Value>::run(const std::function<void(const solution&)>& improved) {
+    nodes++;
+    depth = 0;
+    trail.clear();
+
+    // the nodes forced at the start stay colored for the whole search
+    if (!propagate()) return true;
+
+    if (cur.is_final()) {
+        if (ctx.improve_ub(cur.tot_colors)) improved(cur);
+        return true;
+    }
+
+    // prune internal nodes that require more (or as many) colors than the current known upper bound, or whose lower
+    // bound gets there
+    if (bound.reaches(cur, ctx.colors_ub)) return true;
+
+    expand();
+
+    while (depth > 0) {
+        if (ctx.stop || ctx.colors_ub <= ctx.colors_lb) return false;
+
+        // back from the child of the deepest frame explored last
+        if (trail.size() > frames[depth - 1].mark) undo();
+
+        unsigned int cursor;
+        const unsigned int c = next_color(cur, frames[depth - 1], cursor);
+        if (c == 0) {
+            backjump();
+            continue;
+        }
+
+        descend(c, cursor);
+        nodes++;
+
+        // forward checking prunes the child at once if some node has no color left below the upper bound
+        if (!propagate()) {
+            fail();
+        } else if (cur.is_final()) {
+            if (ctx.improve_ub(cur.tot_colors)) improved(cur);
+            failed_node = NO_NODE;
+            fail();
+        } else if (bound.reaches(cur, ctx.colors_ub)) {
+            failed_node = NO_NODE;
+            fail();
+        } else {
+            expand();
+        }
+
+        if (pool != nullptr && nodes % SPLIT_INTERVAL == 0 && pool->hungry(thread)) split();
+    }
+
+    return true;
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::expand() {
+    if (frames.size() == depth) frames.emplace_back();
+    frame& f = frames[depth++];
+
+    f.node = Node::pick(cur);
+    f.cursor = 0;
+    f.mark = trail.size();
+    f.conflict.assign(words, 0);
+    f.full = false;
+    cur.symmetric_nodes(f.node, f.orbit);
+
+    if constexpr (Value::reorders) {
+        f.order.clear();
+        for (unsigned int c = 1; c <= cur.tot_colors + 1; ++c)
+            if (cur.can_take(f.node, c)) f.order.push_back(c);
+        Value::order(cur, f.node, f.order, f.cost);
+    }
+}
+
+template <typename Node, typename Value>
+unsigned int search_engine<Node, Value>::next_color(const solution& s, const frame& f, unsigned int& cursor) const {
+    const unsigned int ub = ctx.colors_ub;
+
+    if constexpr (Value::reorders) {
+        // a child with as many colors as the upper bound cannot improve on it: only the new color can be one,
+        // wherever the order puts it
+        for (cursor = f.cursor + 1; cursor <= f.order.size(); ++cursor) {
+            const unsigned int c = f.order[cursor - 1];
+            const unsigned int child_colors = c > s.tot_colors ? s.tot_colors + 1 : s.tot_colors;
+            if (child_colors < ub) return c;
+        }
+        return 0;
+    } else {
+        for (unsigned int c = f.cursor + 1; c <= s.tot_colors + 1; ++c) {
+            // a child with as many colors as the upper bound cannot improve on it, nor can the ones after it
+            const unsigned int child_colors = c > s.tot_colors ? s.tot_colors + 1 : s.tot_colors;
+            if (child_colors >= ub) break;
+            if (s.can_take(f.node, c)) {
+                cursor = c;
+                return c;
+            }
+        }
+        return 0;
+    }
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::forbid_symmetric(solution& s, const frame& f, const unsigned int cursor) {
+    if (f.orbit.size() <= 1) return;
+
+    const auto forbid = [&s, &f](const unsigned int j) {
+        for (size_t i = 1; i < f.orbit.size(); ++i) {
+            s.forbidden.push_back(f.orbit[i]);
+            s.forbidden.push_back(j);
+        }
+    };
+
+    if constexpr (Value::reorders) {
+        for (unsigned int k = 0; k + 1 < cursor; ++k) forbid(f.order[k]);
+    } else {
+        for (unsigned int j = 1; j < cursor; ++j)
+            if (s.can_take(f.node, j)) forbid(j);
+    }
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::descend(const unsigned int c, const unsigned int cursor) {
+    frame& f = frames[depth - 1];
+
+    trail.push_back({f.node, cur.tot_colors, cur.forbidden.size()});
+    forbid_symmetric(cur, f, cursor);
+
+    f.cursor = cursor;
+    cur.assign(f.node, c);
+
+    uint64_t* r = reason_row(f.node);
+    std::fill(r, r + words, 0);
+    explained[f.node] = 1;
+    r[(depth - 1) / 64] |= uint64_t(1) << ((depth - 1) % 64);
+    stamp[f.node] = static_cast<unsigned int>(trail.size());
+}
+
+template <typename Node, typename Value>
+bool search_engine<Node, Value>::propagate() {
+    while (!cur.is_final()) {
+        const unsigned int ub = ctx.colors_ub;
+        if (cur.tot_colors >= ub) return true;
+
+        if (cur.wiped_out(ub)) {
+            // every color below ub is around the node
+            failed_node = cur.sat.with_saturation(cur.sat.max_saturation());
+            failed_limit = ub - 1;
+            return false;
+        }
+
+        // a node with ub - 2 colors around it has a single one left below ub: the one color used so far that is
+        // not around it, or else a new one
+        const unsigned int v = cur.sat.with_saturation(ub - 2);
+        if (v == ctx.dim) return true;
+
+        unsigned int c = 1;
+        while (c <= cur.tot_colors && !cur.sat.allowed(v, c)) ++c;
+        if (!cur.can_take(v, c)) {
+            failed_node = NO_NODE;
+            return false;
+        }
+
+        // explained when needed (see reason_of)
+        explained[v] = 0;
+
+        trail.push_back({v, cur.tot_colors, cur.forbidden.size()});
+        cur.assign(v, c);
+        stamp[v] = static_cast<unsigned int>(trail.size());
+    }
+    return true;
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::undo() {
+    const size_t mark = frames[depth - 1].mark;
+    while (trail.size() > mark) {
+        const trail_entry e = trail.back();
+        trail.pop_back();
+
+        cur.unassign(e.node, e.tot_colors);
+        cur.forbidden.resize(e.forbidden);
+    }
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::split() {
+    // back to the starting node (and what it forced) on a copy, then down the current path again, one frame at a
+    // time
+    const size_t base = frames[0].mark;
+    solution s(cur);
+    for (size_t k = trail.size(); k-- > base;) s.unassign(trail[k].node, trail[k].tot_colors);
+    s.forbidden.resize(trail.size() > base ? trail[base].forbidden : cur.forbidden.size());
+
+    for (size_t d = 0; d < depth; ++d) {
+        frame& f = frames[d];
+
+        unsigned int cursor;
+        if (const unsigned int c = next_color(s, f, cursor); c != 0) {
+            solution child(s);
+            forbid_symmetric(child, f, cursor);
+            child.assign(f.node, c);
+
+            // this search goes on after c, and knows nothing of the failure of the child handed out
+            f.cursor = cursor;
+            add_levels(f.conflict.data(), d + 1);
+            f.full = true;
+            pool->give(thread, std::move(child));
+            return;
+        }
+
+        // nothing left at this depth: follow the child being explored, and what it forced
+        const size_t end = d + 1 < depth ? frames[d + 1].mark : trail.size();
+        if (end == f.mark) return;
+        s.forbidden.assign(cur.forbidden.begin(),
+                           cur.forbidden.begin() + (end < trail.size() ? trail[end].forbidden : cur.forbidden.size()));
+        for (size_t k = f.mark; k < end; ++k) s.assign(trail[k].node, cur.color[trail[k].node]);
+    }
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::backjump() {
+    const size_t d = depth - 1;
+    frame& f = frames[d];
+
+    // every color f.node could take failed, and the others are those of a neighbour; unless the coloring uses as
+    // many colors as the upper bound by now, or symmetry ruled some colors out
+    if (!f.full) {
+        bool symmetric = false;
+        for (size_t k = 0; k < cur.forbidden.size() && !symmetric; k += 2) symmetric = cur.forbidden[k] == f.node;
+
+        if (cur.tot_colors >= ctx.colors_ub || symmetric) add_levels(f.conflict.data(), d);
+        else add_around(f.node, cur.tot_colors, 0, f.conflict.data());
+    }
+
+    // no choice of this level makes a difference
+    f.conflict[d / 64] &= ~(uint64_t(1) << (d % 64));
+
+    size_t target = words;
+    while (target-- > 0 && f.conflict[target] == 0) {}
+    if (target == static_cast<size_t>(-1)) {
+        // the failure follows from the start alone
+        depth = 0;
+        return;
+    }
+
+    size_t level = target * 64;
+    for (uint64_t w = f.conflict[target]; w >>= 1;) level++;
+
+    // the frames in between only lead to the same failure
+    frame& back = frames[level];
+    if (!back.full) {
+        for (size_t k = 0; k < words; ++k) back.conflict[k] |= f.conflict[k];
+        back.full = covers(back.conflict.data(), level);
+    }
+    depth = level + 1;
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::fail() {
+    frame& f = frames[depth - 1];
+    if (f.full) return;
+
+    if (failed_node == NO_NODE) add_levels(f.conflict.data(), depth);
+    else add_around(failed_node, failed_limit, 0, f.conflict.data());
+    f.full = covers(f.conflict.data(), depth - 1);
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::add_levels(uint64_t* set, const size_t levels) const {
+    for (size_t k = 0; k < levels / 64; ++k) set[k] = ~uint64_t(0);
+    if (levels % 64 != 0) set[levels / 64] |= (uint64_t(1) << (levels % 64)) - 1;
+}
+
+template <typename Node, typename Value>
+bool search_engine<Node, Value>::covers(const uint64_t* set, const size_t levels) const {
+    for (size_t k = 0; k < levels / 64; ++k)
+        if (set[k] != ~uint64_t(0)) return false;
+    const uint64_t last = (uint64_t(1) << (levels % 64)) - 1;
+    return levels % 64 == 0 || (set[levels / 64] & last) == last;
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::add_around(const unsigned int v, const unsigned int limit, const unsigned int skip,
+                                            uint64_t* set) {
+    const size_t base = witnesses.size();
+    collect(v, limit, skip, NO_NODE);
+
+    for (size_t i = base; i < witnesses.size(); ++i) {
+        const uint64_t* r = reason_of(witnesses[i]);
+        for (size_t k = 0; k < words; ++k) set[k] |= r[k];
+    }
+    witnesses.resize(base);
+}
+
+template <typename Node, typename Value>
+void search_engine<Node, Value>::collect(const unsigned int v, const unsigned int limit, const unsigned int skip,
+                                         const unsigned int before) {
+    for (unsigned int c = 1; c <= limit; ++c) {
+        if (c == skip || cur.sat.allowed(v, c)) continue;
+
+        const unsigned int u = cur.sat.first_neighbor(v, c);
+        if (stamp[u] < before) witnesses.push_back(u);
+    }
+}
+
+template <typename Node, typename Value>
+const uint64_t* search_engine<Node, Value>::reason_of(const unsigned int v) {
+    uint64_t* r = reason_row(v);
+    if (explained[v]) return r;
+
+    // the colors forced on v were all the others below the upper bound of the time
+    const size_t base = witnesses.size();
+    collect(v, cur.tot_colors, cur.color[v], stamp[v]);
+
+    std::fill(r, r + words, 0);
+    for (size_t i = base; i < witnesses.size(); ++i) {
+        const uint64_t* w = reason_of(witnesses[i]);
+        for (size_t k = 0; k < words; ++k) r[k] |= w[k];
+    }
+    witnesses.resize(base);
+
+    explained[v] = 1;
+    return r;
+}
+
+template class search_engine<dsatur_node, first_fit_values>;
+template class search_engine<dsatur_node, least_constraining_values>;
+template class search_engine<dsatur_degree_node, first_fit_values>;
+template class search_engine<dsatur_degree_node, least_constraining_values>;
+template class search_engine<dsatur_free_degree_node, first_fit_values>;
+template class search_engine<dsatur_free_degree_node, least_constraining_values>;
+template class search_engine<domain_degree_node, first_fit_values>;
+template class search_engine<domain_degree_node, least_constraining_values>;
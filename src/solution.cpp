@@ -1,27 +1,21 @@
 #include "solution.h"
-#include <omp.h>
+#include "symmetry.h"
 
 #include <cassert>
+#include <cerrno>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <filesystem>
 
 
 
-size_t solution::dim = -1;
-unsigned int solution::colors_ub = -1;
-unsigned int solution::colors_lb = 0;
-graph * solution::g = nullptr;
-
-
-
-
-solution::solution() : color(solution::dim), tot_colors(0), next(0) {
+solution::solution(const context& ctx) : ctx(&ctx), color(ctx.dim), tot_colors(0), next(0) {
+    sat.reset(*ctx.g, color);
 }
 
 
 bool solution::is_final() const {
-    if (next < solution::dim) return false;
+    if (next < ctx->dim) return false;
     return true;
 }
 
@@ -29,19 +23,38 @@ bool solution::is_final() const {
 [[nodiscard]] std::vector<solution> solution::get_next() const {
     assert(this->is_final() == false && "Cannot generate children of a complete solution!");
 
-    const unsigned int node_to_color = this->node_with_most_colored_neighbors();
+    const unsigned int node_to_color = branching_node();
     const unsigned int colors = tot_colors + 1;
     //const unsigned int colors = dim;
 
     std::vector<solution> children;
     children.reserve(colors);
 
+    std::vector<unsigned int> orbit;
+    symmetric_nodes(node_to_color, orbit);
+
+    // colors the previous children gave node_to_color
+    std::vector<unsigned int> explored;
+
     for (unsigned int i = 1; i <= colors; ++i) {
-        // generate a child node and check if the color assignment is valid. If it is, add it to the list only if the
-        // total number of colors used id no more than the current known upper bound.
-        if (const solution child = solution(*this, node_to_color, i);
-            child.is_valid(node_to_color) && child.tot_colors <= colors_ub) {
-            children.emplace_back(child);
+        // generate a child node if the color assignment is valid, and only if the total number of colors used is no
+        // more than the current known upper bound.
+        const unsigned int child_colors = i > tot_colors ? tot_colors + 1 : tot_colors;
+        if (can_take(node_to_color, i) && child_colors <= ctx->colors_ub) {
+            solution child(*this, node_to_color, i);
+            // a coloring of this subtree giving color c of an earlier child to u is mapped, by the automorphism
+            // taking node_to_color to u, onto a coloring of that child's subtree
+            for (size_t k = 1; k < orbit.size(); ++k) {
+                for (const unsigned int c : explored) {
+                    child.forbidden.push_back(orbit[k]);
+                    child.forbidden.push_back(c);
+                }
+            }
+            explored.push_back(i);
+
+            // some other node has no color left that could lead to fewer colors than the upper bound
+            if (child.wiped_out(ctx->colors_ub)) continue;
+            children.emplace_back(std::move(child));
         }
     }
 
@@ -49,93 +62,84 @@ bool solution::is_final() const {
 }
 
 
-solution::solution(const solution& parent, const unsigned int node_to_color, const unsigned int node_color) {
-    // copy the color assignment from the parent solution
-    this->color = parent.color;
+solution::solution(const solution& parent, const unsigned int node_to_color, const unsigned int node_color)
+    : ctx(parent.ctx), color(parent.color), tot_colors(parent.tot_colors), next(parent.next),
+      forbidden(parent.forbidden), sat(parent.sat) {
+    assign(node_to_color, node_color);
+}
 
-    // copy parameters
-    tot_colors = node_color > parent.tot_colors ? parent.tot_colors + 1 : parent.tot_colors;
-    next = parent.next + 1;
 
-    // color the node
-    color[node_to_color] = node_color;
+[[nodiscard]] unsigned int solution::branching_node() const {
+    return sat.pick();
 }
 
 
-bool solution::is_valid(const unsigned int node_to_check) const {
+void solution::symmetric_nodes(const unsigned int node, std::vector<unsigned int>& out) const {
+    out.assign(1, node);
 
-    const unsigned int i = node_to_check;
-    for (unsigned int j = 0; j < solution::dim; ++j)
-        // if two nodes are adjacent and are colored the same the solution is not valid.
-        if (g->operator()(i, j) == true && color[i] == color[j]) return false;
-
-    return true;
+    // the automorphisms have to fix the colored nodes and those with forbidden colors, so that the constraints of
+    // the subtree are mapped onto themselves
+    const symmetry* sym = ctx->sym;
+    if (sym == nullptr || sym->trivial() || next >= SYMMETRY_MAX_DEPTH) return;
 
+    std::vector<char> fixed(ctx->dim, 0);
+    for (size_t v = 0; v < ctx->dim; ++v) fixed[v] = color[v] != 0;
+    for (size_t k = 0; k < forbidden.size(); k += 2) fixed[forbidden[k]] = 1;
+    sym->orbit(node, fixed, out);
 }
 
-void solution::attach_graph(graph * g) {
-    solution::dim = graph::dim;
-    solution::colors_ub = dim + 1;
 
-    solution::g = g;
+void solution::assign(const unsigned int node, const unsigned int node_color) {
+    if (node_color > tot_colors) tot_colors++;
+    next++;
+    color[node] = node_color;
+    sat.assign(*ctx->g, node, node_color);
 }
 
-[[nodiscard]] unsigned int solution::node_with_most_colored_neighbors() const {
-    size_t max_colored_neighbors = 0;
-    unsigned int best_node = 0;
 
-    // Parallel reduction to find the node with the most colored neighbors
-    #pragma omp parallel
-    {
-        size_t local_max_colored_neighbors = 0;
-        unsigned int local_best_node = 0;
+void solution::unassign(const unsigned int node, const unsigned int previous_tot_colors) {
+    sat.unassign(*ctx->g, node, color[node]);
+    color[node] = 0;
+    next--;
+    tot_colors = previous_tot_colors;
+}
 
-        #pragma omp for nowait
-        for (size_t i = 0; i < dim; ++i) {
-            if (color[i] != 0) continue; // Skip already colored nodes
 
-            std::unordered_set<unsigned int> neighbor_colors;
-            for (size_t j = 0; j < dim; ++j) {
-                if ((*g)(i, j) && color[j] != 0) {
-                    neighbor_colors.insert(color[j]);
-                }
-            }
+bool solution::wiped_out(const unsigned int bound) const {
+    return !is_final() && sat.max_saturation() + 1 >= bound;
+}
 
-            size_t neighbor_count = neighbor_colors.size();
-            if (neighbor_count > local_max_colored_neighbors) {
-                local_max_colored_neighbors = neighbor_count;
-                local_best_node = i;
-            }
-        }
+bool solution::can_take(const unsigned int node, const unsigned int node_color) const {
+    if (!sat.allowed(node, node_color)) return false;
 
-        // Reduce to find the global best node
-        #pragma omp critical
-        {
-            if (local_max_colored_neighbors > max_colored_neighbors) {
-                max_colored_neighbors = local_max_colored_neighbors;
-                best_node = local_best_node;
-            }
-        }
-    }
+    for (size_t k = 0; k < forbidden.size(); k += 2)
+        if (forbidden[k] == node && forbidden[k + 1] == node_color) return false;
 
-    return best_node;
+    return true;
+}
+
+void solution::rebuild_saturation() {
+    sat.reset(*ctx->g, color);
 }
 
 std::ostream& operator<<(std::ostream& os, const solution& sol) {
     os << "Solution:\t\t[ ";
 
-    if (solution::dim > 5) {
+    const size_t dim = sol.ctx->dim;
+    if (dim > 5) {
         os << "... ]\n";
+    } else if (dim == 0) {
+        os << "]\n";
     } else {
-        for (unsigned int i = 0; i < solution::dim - 1; ++i)
+        for (unsigned int i = 0; i < dim - 1; ++i)
             os << sol.color[i] << ", ";
-        os << sol.color[solution::dim - 1] << " ]\n";
+        os << sol.color[dim - 1] << " ]\n";
     }
 
     os << "Next:\t\t\t" << sol.next << "\n";
     os << "Total colors:\t\t" << sol.tot_colors << "\n";
-    os << "Color ub:\t\t" << solution::colors_ub << "\n";
-    os << "Color lb:\t\t" << solution::colors_lb << "\n";
+    os << "Color ub:\t\t" << sol.ctx->colors_ub << "\n";
+    os << "Color lb:\t\t" << sol.ctx->colors_lb << "\n";
 
     return os;
 }
@@ -157,8 +161,8 @@ std::ostream& operator<<(std::ostream& os, const solution& sol) {
     outfile << "problem_instance_file_name: " << instance_name << "\n";
     outfile << "cmd_line: mpirun -n " << n_processes << " ./graph-coloring ../inputs/" << instance_name << " " << time_limit_seconds <<"\n";
     outfile << "solver_version: v1.0.1\n";
-    outfile << "number_of_vertices: " << dim << "\n";
-    outfile << "number_of_edges: " << graph::edges << "\n";
+    outfile << "number_of_vertices: " << ctx->dim << "\n";
+    outfile << "number_of_edges: " << ctx->g->edges << "\n";
     outfile << "time_limit_sec: " << time_limit_seconds << "\n";
     outfile << "number_of_worker_processes: " << n_processes << "\n";
     outfile << "number_of_cores_per_worker: 2\n";
@@ -180,10 +184,10 @@ void solution::write_to_file(const std::string& instance_name, unsigned int time
     std::string folder = base_dir + "/" + (is_optimal ? "out_opt" : "out");
     std::string filepath = folder + "/" + instance_name + ".output";
 
-    // Check folder's existence
+    // Check folder's existence (in batch mode another group may create it at the same time)
     struct stat info;
     if (stat(folder.c_str(), &info) != 0) {
-        if (mkdir(folder.c_str(), 0777) != 0) {
+        if (mkdir(folder.c_str(), 0777) != 0 && errno != EEXIST) {
             std::cerr << "Error: Could not create directory " << folder << std::endl;
             return;
         }
@@ -199,8 +203,8 @@ void solution::write_to_file(const std::string& instance_name, unsigned int time
     outfile << "problem_instance_file_name: " << instance_name << "\n";
     outfile << "cmd_line: srun -n " << n_processes << " ./graph-coloring ../inputs/" << instance_name << " " << time_limit_seconds <<"\n";
     outfile << "solver_version: v1.0.1\n";
-    outfile << "number_of_vertices: " << dim << "\n";
-    outfile << "number_of_edges: " << graph::edges << "\n";
+    outfile << "number_of_vertices: " << ctx->dim << "\n";
+    outfile << "number_of_edges: " << ctx->g->edges << "\n";
     outfile << "time_limit_sec: " << time_limit_seconds << "\n";
     outfile << "number_of_worker_processes: " << n_processes << "\n";
     outfile << "number_of_cores_per_worker: 2\n";
@@ -208,8 +212,14 @@ void solution::write_to_file(const std::string& instance_name, unsigned int time
     outfile << "is_within_time_limit: " << (time_taken < time_limit_seconds ? "true" : "false") << "\n";
     outfile << "number_of_colors: " << tot_colors << "\n";
 
-    for (size_t i = 0; i < color.size(); ++i) {
-        outfile << i << " " << color[i] << "\n";
+    // colors are written for the nodes as numbered in the input file, whatever order the search used
+    const auto& original_id = ctx->g->original_id;
+    std::vector<unsigned int> original_color(color.size());
+    for (size_t i = 0; i < color.size(); ++i)
+        original_color[original_id.empty() ? i : original_id[i]] = color[i];
+
+    for (size_t i = 0; i < original_color.size(); ++i) {
+        outfile << i << " " << original_color[i] << "\n";
     }
 
     outfile.close();
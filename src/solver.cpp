@@ -0,0 +1,680 @@
+#include "solver.h"
+#include "graph_cache.h"
+#include "graph_comm.h"
+#include "maxclique.h"
+#include "reduce.h"
+#include "components.h"
+#include "atoms.h"
+#include "symmetry.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+
+namespace {
+
+constexpr int INITIAL_NODE = 1;
+constexpr int SOLUTION_FROM_WORKER = 2;
+constexpr int RETURN = 3;
+constexpr int RETURN_TIME_LIMIT = 4;
+
+constexpr unsigned int NEW_UB = 6;
+constexpr unsigned int NEW_LB = 9;
+
+constexpr int value_idx = 0;
+constexpr int type_idx = 1;
+
+void send_solution(const solution &sol, const int dest, const int tag, MPI_Comm comm) {
+  // Create a buffer to hold all data
+  const size_t dim = sol.ctx->dim;
+  std::vector<unsigned int> buffer(dim + 2 + sol.forbidden.size());
+
+  // Pack the data: [color vector | tot_colors | next | forbidden pairs]
+  std::copy(sol.color.begin(), sol.color.end(), buffer.begin());
+  buffer[dim] = sol.tot_colors;
+  buffer[dim + 1] = sol.next;
+  std::copy(sol.forbidden.begin(), sol.forbidden.end(), buffer.begin() + dim + 2);
+
+  // Send everything in a single call
+  MPI_Send(buffer.data(), buffer.size(), MPI_UNSIGNED, dest, tag, comm);
+}
+
+void receive_solution(solution &sol, const int source, const int tag, MPI_Comm comm, MPI_Status &status) {
+  // the length depends on the forbidden pairs: probe the message first
+  const size_t dim = sol.ctx->dim;
+  MPI_Message message;
+  MPI_Mprobe(source, tag, comm, &message, &status);
+
+  int count;
+  MPI_Get_count(&status, MPI_UNSIGNED, &count);
+  std::vector<unsigned int> buffer(count);
+
+  // Receive everything in a single call
+  MPI_Mrecv(buffer.data(), count, MPI_UNSIGNED, &message, &status);
+
+  // Unpack the data
+  sol.color.assign(buffer.begin(), buffer.begin() + dim);
+  sol.tot_colors = buffer[dim];
+  sol.next = buffer[dim + 1];
+  sol.forbidden.assign(buffer.begin() + dim + 2, buffer.end());
+  sol.rebuild_saturation();
+}
+
+// root only: broadcasts a control message to the listener threads of the workers. Once RETURN or
+// RETURN_TIME_LIMIT went out nobody is listening anymore, so later messages are dropped.
+bool broadcast_control(context &ctx, const unsigned int value, const unsigned int type) {
+  std::lock_guard<std::mutex> lock(ctx.control_mutex);
+  if (ctx.control_closed) return false;
+
+  if (type == RETURN || type == RETURN_TIME_LIMIT) ctx.control_closed = true;
+
+  unsigned int message[2];
+  message[value_idx] = value;
+  message[type_idx] = type;
+  MPI_Bcast(message, 2, MPI_UNSIGNED, 0, ctx.control_comm);
+
+  return true;
+}
+
+// state of the root process while the workers search
+struct root_state {
+  context* ctx;
+
+  // best solution so far, and whether the tree has been fully explored
+  solution best;
+  bool optimality;
+};
+
+// this function is executed by a thread on each worker process
+void* listen_for_ub_updates_from_root(void* arg) {
+  context* ctx = static_cast<context*>(arg);
+
+  while (true) {
+    // Blocking call: Will wait here until rank 0 broadcasts a message
+    unsigned int message[2];
+    MPI_Bcast(message, 2, MPI_UNSIGNED, 0, ctx->control_comm);
+
+    if (message[type_idx] == RETURN) break;
+
+    if (message[type_idx] == RETURN_TIME_LIMIT) {
+      ctx->stop = true;
+      break;
+    }
+
+    if (message[type_idx] == NEW_LB && message[value_idx] > ctx->colors_lb) {
+      const unsigned int new_lb = message[value_idx];
+      ctx->colors_lb = new_lb;
+
+      //std::cout << "New color lb is " << new_lb << std::endl;
+    }
+
+    if (message[type_idx] == NEW_UB) {
+      ctx->improve_ub(message[value_idx]);
+      //std::cout << "Process " << rank << " received new ub: " << ctx->colors_ub << std::endl;
+    }
+  }
+
+  return nullptr;
+
+}
+
+void* listen_for_ub_updates_from_workers(void* arg) {
+  root_state* state = static_cast<root_state*>(arg);
+  context* ctx = state->ctx;
+
+  int comm_size;
+  MPI_Comm_size(ctx->comm, &comm_size);
+
+  int worker_done = 0;
+
+  // while at least one worker has not finished
+  while (worker_done < comm_size - 1) {
+    MPI_Status status;
+    solution new_best(*ctx);
+    receive_solution(new_best, MPI_ANY_SOURCE, MPI_ANY_TAG, ctx->comm, status);
+
+    if(status.MPI_TAG == RETURN) {
+      worker_done += 1;
+    }
+
+    // a worker out of time still sends RETURN last: receiving it is what lets its send complete
+    if(status.MPI_TAG == RETURN_TIME_LIMIT) {
+      state->optimality = false;
+    }
+
+    if(status.MPI_TAG == SOLUTION_FROM_WORKER) {
+      // if the new best solution is actually better
+      if(new_best.tot_colors < ctx->colors_ub) {
+        // update upper bound in rank 0 memory
+        ctx->colors_ub = new_best.tot_colors;
+        state->best = new_best;
+
+        std::cout << "Process " << status.MPI_SOURCE << " sent solution:\n" << new_best << "\n";
+
+        // broadcast new upperbound to workers
+        broadcast_control(*ctx, new_best.tot_colors, NEW_UB);
+      }
+    }
+  }
+
+  // broadcast workers we are done
+  broadcast_control(*ctx, 0, RETURN);
+
+  return nullptr;
+
+}
+
+void* timer_thread(void* arg) {
+  context* ctx = static_cast<context*>(arg);
+
+  // sleep until the deadline, unless the search ends first
+  std::unique_lock<std::mutex> lock(ctx->control_mutex);
+  const bool finished = ctx->control_cv.wait_until(lock, ctx->deadline, [ctx] { return ctx->finished; });
+  lock.unlock();
+
+  // broadcast workers we are done
+  if (!finished) broadcast_control(*ctx, 0, RETURN_TIME_LIMIT);
+
+  return nullptr;
+}
+
+// Compute lower bound via max clique
+void* compute_lb(void* ctx_ptr) {
+  context* ctx = static_cast<context*>(ctx_ptr);
+  const int max_clique_size = static_cast<int>(find_max_clique(*ctx->g, ctx->stop).size());
+
+  // the search ended before the clique search did
+  if (ctx->stop) return nullptr;
+
+  printf("===== LOWER BOUND (Max Clique): %d =====\n\n", max_clique_size);
+
+  // a bound known from the start (the clique of the reduced graph) may be better
+  if (static_cast<unsigned int>(max_clique_size) <= ctx->colors_lb) return nullptr;
+
+  // Update the lower bound of the problem (ctx->colors_lb)
+  ctx->colors_lb = max_clique_size;
+
+  // Communicate new lb to all processes via MPI
+  broadcast_control(*ctx, static_cast<unsigned int>(max_clique_size), NEW_LB);
+
+  return nullptr;
+}
+
+solution solve_root(context& ctx, bool& optimal) {
+  int rank, size;
+  MPI_Comm_rank(ctx.comm, &rank); MPI_Comm_size(ctx.comm, &size);
+
+  // summon timer thread
+  pthread_t timer;
+  pthread_create(&timer, nullptr, timer_thread, &ctx);
+
+  // start to look for a lower bound
+  pthread_t lb_thread;
+  pthread_create(&lb_thread, nullptr, compute_lb, &ctx);
+
+  std::queue<solution> initial_q{};
+
+  // the clique takes its colors first, which saves their permutations and starts the search where it is densest
+  solution s(ctx);
+  for (size_t k = 0; k < ctx.clique.size(); ++k) s.assign(ctx.clique[k], static_cast<unsigned int>(k) + 1);
+  initial_q.push(s);
+
+  root_state state{&ctx, solution(ctx), true};
+
+  while(!initial_q.empty()) {
+
+    // pop the first element in the stack
+    auto curr = initial_q.front(); initial_q.pop();
+
+    if(!curr.is_final()) {
+
+      // prune internal nodes that require more (or as many) colors than the current known upperbound
+      if(curr.tot_colors >= ctx.colors_ub) continue;
+
+      // generate children nodes
+      auto tmp = curr.get_next();
+
+      // add them to the queue, unless it gets longer than the number of processes available
+      if(initial_q.size() + tmp.size() <= static_cast<size_t>(size - 1)) {
+        for(auto & child : tmp)
+          initial_q.push(child);
+      } else {
+        initial_q.push(curr);
+        break;
+      }
+
+    } else if (curr.tot_colors < ctx.colors_ub) {
+      // if the current solution is better than the previous one (or if it is the first optimal solution)
+
+      // update the upper bound, the current best solution and print it
+      ctx.colors_ub = curr.tot_colors;
+      state.best = curr;
+      std::cout << curr << std::endl;
+    }
+  }
+
+  // at this point either the solution is found OR we can start assigning work to each process
+  if( initial_q.empty() ) {
+    std::cout << "NO PARALLELISM USED: the whole tree was explored by process " << rank << "\n" << std::endl;
+  } else {
+    std::cout << "\nProcess " << rank << " generated an initial queue with " << initial_q.size() << " nodes.\n\n";
+    std::cout << "Current color upper bound is: " << ctx.colors_ub << "\n\n";
+    std::cout << (size - 1) - initial_q.size() << " worker processes will do nothing.\n\n";
+  }
+
+  // main process now dispatches each node to a worker process
+  int i = 1;
+  while ( !initial_q.empty() ) {
+    send_solution(initial_q.front(), i, INITIAL_NODE, ctx.comm);
+    initial_q.pop();
+    i++;
+  }
+
+  const solution dummy_solution(ctx);
+  while ( i < size ) {
+    send_solution(dummy_solution, i, 0, ctx.comm);
+    i++;
+  }
+
+  std::cout << "Process " << rank << " sent starting node to workers.\n\n";
+
+  // start thread to listen to solutions found by worker threads
+  pthread_t listener_thread;
+  pthread_create(&listener_thread, nullptr, listen_for_ub_updates_from_workers, &state);
+
+  // wait for workers to finish
+  MPI_Barrier(ctx.comm);
+
+  pthread_join(listener_thread, nullptr);
+
+  // the search is over: wake the timer up and interrupt the lower bound search
+  {
+    std::lock_guard<std::mutex> lock(ctx.control_mutex);
+    ctx.finished = true;
+  }
+  ctx.control_cv.notify_all();
+  ctx.stop = true;
+
+  pthread_join(timer, nullptr);
+  pthread_join(lb_thread, nullptr);
+
+  optimal = state.optimality;
+  return state.best;
+}
+
+void solve_worker(context& ctx) {
+  int rank;
+  MPI_Comm_rank(ctx.comm, &rank);
+
+  solution sol_init_loc(ctx);
+
+  // wait for initial node from proces 0
+  MPI_Status status;
+  receive_solution(sol_init_loc, 0, MPI_ANY_TAG, ctx.comm, status);
+
+  // summon listener thread
+  pthread_t listener_thread;
+  pthread_create(&listener_thread, nullptr, listen_for_ub_updates_from_root, &ctx);
+
+  // if a message was received with a tag different from zero, the worker thread does nothing
+  if(status.MPI_TAG != INITIAL_NODE) {
+    std::cout << "Process " << rank << " did not receive a node!\n\n";
+
+  } else {
+    //std::cout << "Process " << rank << " received the solution:\n" << sol_init_loc << std::endl;
+
+    // depth-first search below the received node, by ctx.threads threads
+    work_pool pool(ctx, ctx.threads);
+    solution best_so_far(ctx);
+    unsigned long long nodes = 0;
+
+    const bool exhausted = pool.run(sol_init_loc, [&](const solution& improved) {
+      // the upper bound is already updated: keep the solution and communicate it to root process (rank 0)
+      if (best_so_far.is_final() && best_so_far.tot_colors <= improved.tot_colors) return;
+      best_so_far = improved;
+      send_solution(best_so_far, 0, SOLUTION_FROM_WORKER, ctx.comm);
+    }, nodes);
+
+    // for good measure
+    if (best_so_far.is_final())
+      send_solution(best_so_far, 0, SOLUTION_FROM_WORKER, ctx.comm);
+
+    // if the search stopped before exhausting the subtree, the tree was not fully explored and we can no longer
+    // claim optimality, unless it stopped due to ub reaching lb
+    solution dummy_sol(ctx);
+    if (exhausted) {
+      std::cout << "Process " << rank << " emptied queue! (" << nodes << " nodes)\n\n";
+    } else if (ctx.colors_ub > ctx.colors_lb) {
+      send_solution(dummy_sol, 0, RETURN_TIME_LIMIT, ctx.comm);
+      std::cout << "Process " << rank << " time is up! (" << nodes << " nodes)\n\n";
+    } else {
+      printf("Process %d terminating early!\n\n", rank);
+    }
+
+  }
+
+  // communicate to root process this process is done
+  solution dummy(ctx);
+  send_solution(dummy, 0, RETURN, ctx.comm);
+
+  // let rank 0 node know computation is completed
+  MPI_Barrier(ctx.comm);
+
+  // wait return of listener thread
+  pthread_join(listener_thread, nullptr);
+}
+
+// prints the outcome of a search and writes it to out/ or out_opt/
+void write_result(const solution& best, const bool optimal, const std::string& instance_name, const double seconds,
+                  const int n_processes, const unsigned int time_limit) {
+  if (best.is_final() && optimal) {
+    std::cout << "===== OPTIMAL SOLUTION =====\n" << best << "============================" << std::endl;
+    best.write_to_file(instance_name, seconds, n_processes, time_limit, true);
+  }
+  else if (best.is_final() && !optimal) {
+    std::cout << "===== SUB-OPT SOLUTION =====\n" << best << "============================" << std::endl;
+    best.write_to_file(instance_name, seconds, n_processes, time_limit, false);
+  }
+  else
+    std::cout << "No solutions found." << std::endl;
+
+  std::cout << std::flush;
+}
+
+}
+
+decision_mode parse_decision_mode(const std::string& name) {
+  if (name == "none") return decision_mode::none;
+  if (name == "down") return decision_mode::down;
+  if (name == "up") return decision_mode::up;
+  throw std::runtime_error("Error: unknown decision mode '" + name + "' (none, down, up)");
+}
+
+std::string to_string(const decision_mode mode) {
+  switch (mode) {
+    case decision_mode::down: return "down";
+    case decision_mode::up: return "up";
+    default: return "none";
+  }
+}
+
+solution solve(context& ctx, bool& optimal) {
+  int rank;
+  MPI_Comm_rank(ctx.comm, &rank);
+
+  optimal = false;
+  if (rank == 0) return solve_root(ctx, optimal);
+
+  solve_worker(ctx);
+  return solution(ctx);
+}
+
+void solve_instance(const std::string& file_path, MPI_Comm comm, const solver_options& opt) {
+  const auto start = context::clock::now();
+  const auto deadline = start + std::chrono::seconds(opt.time_limit);
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank); MPI_Comm_size(comm, &size);
+
+  const std::string instance_name = std::filesystem::path(file_path).filename().string();
+
+  // rank 0 loads the graph and reduces it; a broken instance is skipped by the whole group
+  graph g{};
+  graph kernel{};
+  reduction red;
+
+  // [loaded | lower bound the kernel was reduced with]
+  unsigned long long info[2] = {1, 0};
+
+  if (rank == 0) {
+    try {
+      g = load_graph(file_path, opt.use_cache);
+
+      if (opt.order != vertex_order::none) {
+        const auto reorder_start = context::clock::now();
+        const size_t band = bandwidth(g);
+        g = permute_graph(g, compute_order(g, opt.order));
+        const std::chrono::duration<double> reorder_time = context::clock::now() - reorder_start;
+        std::cout << "Nodes relabelled in " << to_string(opt.order) << " order (" << reorder_time.count()
+                  << " s), bandwidth " << band << " -> " << bandwidth(g) << "\n" << std::endl;
+      }
+
+      if (opt.reduce) {
+        red = reduce_graph(g, static_cast<unsigned int>(greedy_clique(g).size()));
+        kernel = g.induced_subgraph(red.kernel_nodes);
+        std::cout << "Reduction (clique of " << red.lower_bound << "): " << red.low_degree << " nodes of low degree and "
+                  << red.dominated << " dominated nodes removed, " << kernel.dim << " of " << g.dim << " left\n" << std::endl;
+      }
+    } catch (std::exception &e) {
+      std::cerr << e.what() << "\n";
+      info[0] = 0;
+    }
+
+    info[1] = red.lower_bound;
+  }
+
+  MPI_Bcast(info, 2, MPI_UNSIGNED_LONG_LONG, 0, comm);
+  if (!info[0]) return;
+
+  const graph& search_graph = opt.reduce ? kernel : g;
+
+  // rank 0 splits search_graph into connected components, and those into atoms along clique separators, then
+  // colors the atoms one at a time, smallest first. The number of colors of the graph is the largest over the
+  // atoms, so once an atom needs k colors the following ones are done as soon as they fit in k: most are settled
+  // by a greedy coloring, the others are searched by every process. Their colorings are glued at the end
+  atom_decomposition atoms;
+  std::vector<std::vector<unsigned int>> atom_color;
+  std::vector<size_t> pieces;
+  size_t next_piece = 0;
+
+  // a coloring of the graph needs at least target colors: the clique of the reduction, then the largest number
+  // of colors an atom needed so far
+  unsigned int target = static_cast<unsigned int>(info[1]);
+  bool optimal = true;
+
+  // colors the graph is proven to need (rank 0): the largest lower bound of an atom
+  unsigned int lower = target;
+  size_t searched = 0;
+
+  if (rank == 0) {
+    if (opt.decompose) {
+      atoms = decompose_atoms(search_graph);
+    } else {
+      // connected components only
+      atoms.atoms = connected_components(search_graph);
+      atoms.separators.resize(atoms.atoms.size());
+    }
+    atom_color.resize(atoms.atoms.size());
+
+    for (size_t i = 0; i < atoms.atoms.size(); ++i) pieces.push_back(i);
+    std::stable_sort(pieces.begin(), pieces.end(), [&atoms](const size_t a, const size_t b) {
+      return atoms.atoms[a].size() < atoms.atoms[b].size();
+    });
+
+    if (pieces.size() > 1) {
+      const size_t separated = std::count_if(atoms.separators.begin(), atoms.separators.end(),
+                                             [](const auto& sep) { return !sep.empty(); });
+      std::cout << pieces.size() << " pieces (" << pieces.size() - separated << " connected components, "
+                << separated << " split off by clique separators), the largest with "
+                << atoms.atoms[pieces.back()].size() << " nodes\n" << std::endl;
+    }
+  }
+
+  while (true) {
+    // rank 0 settles atoms until one needs a search:
+    // [nodes of the atom (0 when done) | lower bound | colors of the greedy coloring]
+    graph piece{};
+    std::vector<unsigned int> greedy_color, clique;
+    unsigned int greedy_colors = 0;
+    unsigned long long task[3] = {0, 0, 0};
+
+    if (rank == 0) {
+      for (; next_piece < pieces.size(); ++next_piece) {
+        piece = search_graph.induced_subgraph(atoms.atoms[pieces[next_piece]]);
+        greedy_colors = greedy_coloring(piece, greedy_color);
+
+        clique = greedy_clique(piece);
+        const unsigned int lb = std::max(target, static_cast<unsigned int>(clique.size()));
+
+        // out of time: keep the greedy coloring
+        const bool expired = context::clock::now() >= deadline;
+        if (greedy_colors <= lb || expired) {
+          atom_color[pieces[next_piece]] = greedy_color;
+          target = std::max(target, greedy_colors);
+          lower = std::max(lower, greedy_colors <= lb ? greedy_colors : lb);
+          if (greedy_colors > lb) optimal = false;
+          continue;
+        }
+
+        task[0] = piece.dim;
+        task[1] = lb;
+        task[2] = greedy_colors;
+        break;
+      }
+    }
+
+    MPI_Bcast(task, 3, MPI_UNSIGNED_LONG_LONG, 0, comm);
+    if (task[0] == 0) break;
+
+    if (rank == 0)
+      std::cout << "Searching piece " << next_piece + 1 << " of " << pieces.size() << " (" << task[0]
+                << " nodes, greedy coloring with " << greedy_colors << " colors)\n" << std::endl;
+
+    // send the atom to other processes, stored once per node
+    shared_graph_window graph_window = share_graph(piece, 0, comm);
+
+    // its automorphisms, which let the search skip branches symmetric to explored ones
+    symmetry sym;
+    if (opt.symmetry) {
+      if (rank == 0) {
+        // a share of the time left, so that the coloring search always gets most of it
+        const auto sym_start = context::clock::now();
+        sym = find_symmetries(piece, sym_start + (deadline - sym_start) / SYMMETRY_TIME_SHARE);
+        const std::chrono::duration<double> sym_time = context::clock::now() - sym_start;
+        if (!sym.trivial())
+          std::cout << sym.perms.size()
+                    << (!sym.listed ? " generators of the automorphism group"
+                                    : sym.complete ? " automorphisms" : " automorphisms (of a subgroup of the group)")
+                    << " found (" << sym_time.count() << " s)\n" << std::endl;
+      }
+      broadcast_symmetry(sym, piece.dim, 0, comm);
+    }
+
+    // the piece needs lo colors at least, and best_color uses hi (known on rank 0)
+    unsigned int lo = static_cast<unsigned int>(task[1]), hi = static_cast<unsigned int>(task[2]);
+    std::vector<unsigned int> best_color = greedy_color;
+    bool interrupted = false;
+
+    // rounds of search, each one raising lo or lowering hi, until they meet or time is up: a single search for
+    // colorings better than hi, or decision searches "is the piece k-colorable?" (k + 1 as upper bound and k as
+    // lower bound, so that the first k-coloring ends the search). [upper bound | lower bound] of the round, or 0
+    while (true) {
+      unsigned long long round[2] = {0, 0};
+      if (rank == 0 && lo < hi && !interrupted && context::clock::now() < deadline) {
+        if (opt.decision == decision_mode::none) {
+          round[0] = hi;
+          round[1] = lo;
+        } else {
+          const unsigned int k = opt.decision == decision_mode::down ? hi - 1 : lo;
+          round[0] = k + 1;
+          round[1] = k;
+          std::cout << "Is the piece " << k << "-colorable? (between " << lo << " and " << hi << " colors)\n" << std::endl;
+        }
+      }
+
+      MPI_Bcast(round, 2, MPI_UNSIGNED_LONG_LONG, 0, comm);
+      if (round[0] == 0) break;
+
+      // private communicators, so that messages of this search never mix with anything else running on comm
+      MPI_Comm solve_comm, control_comm;
+      MPI_Comm_dup(comm, &solve_comm);
+      MPI_Comm_dup(comm, &control_comm);
+
+      {
+        context ctx(&piece, solve_comm, control_comm, deadline);
+        ctx.sym = &sym;
+        ctx.clique = clique;
+        ctx.colors_ub = static_cast<unsigned int>(round[0]);
+        ctx.colors_lb = static_cast<unsigned int>(round[1]);
+        ctx.threads = opt.threads;
+        ctx.branch_node = opt.branch_node;
+        ctx.branch_value = opt.branch_value;
+
+        bool round_optimal;
+        const solution best = solve(ctx, round_optimal);
+
+        if (rank == 0) {
+          if (best.is_final()) {
+            hi = best.tot_colors;
+            best_color = best.color;
+          }
+
+          // an exhausted tree rules out colorings below its final upper bound, unless the search stopped there
+          // because it reached the lower bound of the round
+          const unsigned int reached = best.is_final() ? best.tot_colors : static_cast<unsigned int>(round[0]);
+          if (round_optimal && reached > round[1]) lo = std::max(lo, reached);
+
+          // the lower bound was raised during the round by the clique search
+          if (ctx.colors_lb > round[1]) lo = std::max(lo, ctx.colors_lb.load());
+
+          interrupted = !round_optimal;
+
+          if (opt.decision != decision_mode::none) {
+            if (best.is_final()) std::cout << "Yes: colored with " << hi << " colors\n" << std::endl;
+            else if (!interrupted) std::cout << "No: lower bound raised to " << lo << "\n" << std::endl;
+            else std::cout << "Unknown: time is up\n" << std::endl;
+          }
+        }
+      }
+
+      MPI_Comm_free(&control_comm);
+      MPI_Comm_free(&solve_comm);
+    }
+
+    if (rank == 0) {
+      // if the search found nothing better, the greedy coloring stands (and is optimal if the tree was exhausted)
+      atom_color[pieces[next_piece]] = best_color;
+
+      target = std::max(target, hi);
+      lower = std::max(lower, lo);
+      optimal = optimal && lo >= hi;
+      next_piece++;
+      searched++;
+    }
+
+    free_shared_graph(graph_window);
+  }
+
+  if (rank == 0) {
+    const std::chrono::duration<double> duration = context::clock::now() - start;
+
+    if (pieces.size() > 1)
+      std::cout << searched << " of " << pieces.size() << " pieces needed a search\n" << std::endl;
+
+    // glue the atoms, put the removed nodes back, and write the coloring of the whole graph
+    std::vector<unsigned int> search_color;
+    const unsigned int search_colors = glue_colorings(search_graph, atoms, atom_color, search_color);
+
+    context full_ctx(&g);
+    solution result(full_ctx);
+    if (opt.reduce) {
+      result.tot_colors = extend_coloring(g, red, search_color, result.color);
+    } else {
+      result.color = search_color;
+      result.tot_colors = search_colors;
+    }
+    result.next = static_cast<unsigned int>(g.dim);
+    full_ctx.colors_ub = result.tot_colors;
+    // printed with the result: a coloring that is not optimal is within [lower, tot_colors]
+    full_ctx.colors_lb = lower;
+
+    write_result(result, optimal, instance_name, duration.count(), size, opt.time_limit);
+  }
+}
@@ -0,0 +1,281 @@
+#include "symmetry.h"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+namespace {
+
+constexpr unsigned int NO_CELL = static_cast<unsigned int>(-1);
+
+// ordered partition of the nodes: node v is in cell[v], the cells being numbered 0 ... cells - 1
+struct partition {
+    std::vector<unsigned int> cell;
+    unsigned int cells = 0;
+};
+
+using clock = std::chrono::steady_clock;
+
+class refiner {
+public:
+    refiner(const graph& g, const clock::time_point deadline)
+        : g(g), deadline(deadline), order(g.dim), next(g.dim), key(g.adj_offset[g.dim]) {}
+
+    // turns p into the coarsest equitable partition finer than it: nodes stay together only as long as they have
+    // as many neighbours in each cell. Cells are numbered by sorting (cell, cells of the neighbours), so relabelling
+    // the graph relabels the result the same way. Gives up, leaving p half refined, once stopped()
+    void refine(partition& p) {
+        const size_t n = g.dim;
+
+        while (true) {
+            // each pass scans every node and adjacency entry
+            if (work > SYMMETRY_MAX_WORK) over_budget = true;
+            else if (clock::now() >= deadline) out_of_time = true;
+            if (stopped()) return;
+            work += n + g.adj_offset[n];
+
+            for (unsigned int v = 0; v < n; ++v) {
+                unsigned int* k = key.data() + g.adj_offset[v];
+                for (const unsigned int u : g.neighbors(v)) *k++ = p.cell[u];
+                std::sort(key.data() + g.adj_offset[v], k);
+            }
+
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [this, &p](const unsigned int a, const unsigned int b) {
+                return less(p, a, b);
+            });
+
+            unsigned int cells = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (i > 0 && less(p, order[i - 1], order[i])) cells++;
+                next[order[i]] = cells;
+            }
+            cells++;
+
+            const bool stable = cells == p.cells;
+            p.cell.swap(next);
+            p.cells = cells;
+            if (stable) return;
+        }
+    }
+
+    // the budget or the time ran out: no more refinements
+    bool stopped() const { return over_budget || out_of_time; }
+
+    bool over_budget = false;
+    bool out_of_time = false;
+
+private:
+    bool less(const partition& p, const unsigned int a, const unsigned int b) const {
+        if (p.cell[a] != p.cell[b]) return p.cell[a] < p.cell[b];
+        return std::lexicographical_compare(key.data() + g.adj_offset[a], key.data() + g.adj_offset[a + 1],
+                                            key.data() + g.adj_offset[b], key.data() + g.adj_offset[b + 1]);
+    }
+
+    const graph& g;
+    const clock::time_point deadline;
+    size_t work = 0;
+    std::vector<unsigned int> order, next;
+
+    // the sorted cells of the neighbours of v are key[adj_offset[v]] ... key[adj_offset[v + 1] - 1]
+    std::vector<unsigned int> key;
+};
+
+// p with v moved to a cell of its own, just before the rest of its old cell (not refined yet)
+partition individualize(const partition& p, const unsigned int v) {
+    partition q;
+    q.cell.resize(p.cell.size());
+    for (size_t u = 0; u < p.cell.size(); ++u) q.cell[u] = 2 * p.cell[u] + 1;
+    q.cell[v] = 2 * p.cell[v];
+    q.cells = p.cells + 1;
+    return q;
+}
+
+std::vector<unsigned int> cell_sizes(const partition& p) {
+    std::vector<unsigned int> sizes(p.cells, 0);
+    for (const unsigned int c : p.cell) sizes[c]++;
+    return sizes;
+}
+
+// first of the smallest cells with more than one node, NO_CELL if p is discrete
+unsigned int target_cell(const std::vector<unsigned int>& sizes) {
+    unsigned int best = NO_CELL;
+    for (unsigned int c = 0; c < sizes.size(); ++c)
+        if (sizes[c] > 1 && (best == NO_CELL || sizes[c] < sizes[best])) best = c;
+    return best;
+}
+
+class automorphism_search {
+public:
+    automorphism_search(const graph& g, const clock::time_point deadline) : g(g), ref(g, deadline) {}
+
+    // generators of the automorphism group (all of them unless the search stopped, none if it ran out of time)
+    std::vector<std::vector<unsigned int>> generators() {
+        const size_t n = g.dim;
+        std::vector<std::vector<unsigned int>> gens;
+
+        // first path: always the first node of the target cell, down to a discrete partition
+        partition p;
+        p.cell.assign(n, 0);
+        p.cells = 1;
+        ref.refine(p);
+        if (ref.stopped()) return gens;
+        while (true) {
+            path.push_back(p);
+            shapes.push_back(cell_sizes(p));
+            target.push_back(target_cell(shapes.back()));
+            if (target.back() == NO_CELL) break;
+
+            const unsigned int v = static_cast<unsigned int>(
+                std::find(p.cell.begin(), p.cell.end(), target.back()) - p.cell.begin());
+            first_path.push_back(v);
+            p = individualize(p, v);
+            ref.refine(p);
+            if (ref.stopped()) return gens;
+        }
+        first_leaf.resize(n);
+        for (unsigned int v = 0; v < n; ++v) first_leaf[p.cell[v]] = v;
+
+        // orbits of the group generated so far, as a union-find forest
+        std::vector<unsigned int> parent(n);
+        std::iota(parent.begin(), parent.end(), 0);
+        const auto root = [&parent](unsigned int v) {
+            while (parent[v] != v) v = parent[v] = parent[parent[v]];
+            return v;
+        };
+
+        // at level l, the generators found below all fix first_path[0 ... l - 1]: a node of the target cell in
+        // the orbit of first_path[l] leads to a subtree equivalent to the first one
+        std::vector<unsigned int> perm(n);
+        for (size_t l = first_path.size(); l-- > 0 && !ref.stopped();) {
+            for (unsigned int w = 0; w < n && !ref.stopped(); ++w) {
+                if (path[l].cell[w] != target[l] || root(w) == root(first_path[l])) continue;
+                if (!find(path[l], w, l, perm)) continue;
+
+                gens.push_back(perm);
+                for (unsigned int v = 0; v < n; ++v) parent[root(v)] = root(perm[v]);
+            }
+        }
+
+        return gens;
+    }
+
+    // the search stopped before the end: the generators are those found so far
+    bool out_of_budget() const { return ref.over_budget; }
+
+    // the search gave up when the deadline passed
+    bool out_of_time() const { return ref.out_of_time; }
+
+private:
+    // looks below p (a partition at level l) with w individualized for a leaf matching the first one; on success
+    // perm maps the first leaf to it, and is an automorphism
+    bool find(const partition& p, const unsigned int w, const size_t l, std::vector<unsigned int>& perm) {
+        partition q = individualize(p, w);
+        ref.refine(q);
+        if (ref.stopped() || cell_sizes(q) != shapes[l + 1]) return false;
+
+        if (l + 1 == first_path.size()) {
+            for (unsigned int v = 0; v < g.dim; ++v) perm[first_leaf[q.cell[v]]] = v;
+            return is_automorphism(perm);
+        }
+
+        for (unsigned int x = 0; x < g.dim && !ref.stopped(); ++x)
+            if (q.cell[x] == target[l + 1] && find(q, x, l + 1, perm)) return true;
+        return false;
+    }
+
+    bool is_automorphism(const std::vector<unsigned int>& perm) const {
+        for (unsigned int v = 0; v < g.dim; ++v)
+            for (const unsigned int u : g.neighbors(v))
+                if (!g(perm[v], perm[u])) return false;
+        return true;
+    }
+
+    const graph& g;
+    refiner ref;
+
+    // the first path of the search tree: partition, sizes of its cells and target cell at each level, the node
+    // individualized there, and the discrete partition it ends with (first_leaf[i] is the node in cell i)
+    std::vector<partition> path;
+    std::vector<std::vector<unsigned int>> shapes;
+    std::vector<unsigned int> target;
+    std::vector<unsigned int> first_path;
+    std::vector<unsigned int> first_leaf;
+};
+
+}
+
+void symmetry::orbit(const unsigned int v, const std::vector<char>& fixed, std::vector<unsigned int>& out) const {
+    out.assign(1, v);
+    if (fixed[v]) return;
+
+    std::vector<const std::vector<unsigned int>*> usable;
+    std::vector<unsigned int> fixed_nodes;
+    for (unsigned int u = 0; u < fixed.size(); ++u)
+        if (fixed[u]) fixed_nodes.push_back(u);
+    for (const auto& p : perms)
+        if (std::all_of(fixed_nodes.begin(), fixed_nodes.end(), [&p](const unsigned int u) { return p[u] == u; }))
+            usable.push_back(&p);
+
+    for (size_t head = 0; head < out.size(); ++head) {
+        for (const auto* p : usable) {
+            const unsigned int u = (*p)[out[head]];
+            if (std::find(out.begin(), out.end(), u) == out.end()) out.push_back(u);
+        }
+    }
+}
+
+symmetry find_symmetries(const graph& g, const clock::time_point deadline) {
+    symmetry sym;
+    if (g.dim == 0 || g.dim > SYMMETRY_MAX_NODES) return sym;
+
+    automorphism_search search(g, deadline);
+    const auto gens = search.generators();
+    if (gens.empty() || search.out_of_time()) return sym;
+
+    // list the group, unless it turns out too large
+    std::vector<unsigned int> identity(g.dim);
+    std::iota(identity.begin(), identity.end(), 0);
+    std::set<std::vector<unsigned int>> seen{identity};
+    std::vector<std::vector<unsigned int>> elements{identity};
+
+    std::vector<unsigned int> product(g.dim);
+    for (size_t i = 0; i < elements.size() && elements.size() <= SYMMETRY_MAX_ELEMENTS; ++i) {
+        for (const auto& s : gens) {
+            for (unsigned int v = 0; v < g.dim; ++v) product[v] = s[elements[i][v]];
+            if (seen.insert(product).second) elements.push_back(product);
+        }
+    }
+
+    if (elements.size() <= SYMMETRY_MAX_ELEMENTS) {
+        sym.perms.assign(elements.begin() + 1, elements.end());
+        sym.listed = true;
+        sym.complete = !search.out_of_budget();
+    } else {
+        sym.perms = gens;
+    }
+
+    return sym;
+}
+
+void broadcast_symmetry(symmetry& sym, const size_t dim, const int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // [number of permutations | listed | complete]
+    unsigned long long header[3] = {sym.perms.size(), sym.listed, sym.complete};
+    MPI_Bcast(header, 3, MPI_UNSIGNED_LONG_LONG, root, comm);
+
+    std::vector<unsigned int> flat(header[0] * dim);
+    if (rank == root)
+        for (size_t k = 0; k < sym.perms.size(); ++k) std::copy(sym.perms[k].begin(), sym.perms[k].end(), flat.begin() + k * dim);
+
+    if (!flat.empty()) MPI_Bcast(flat.data(), static_cast<int>(flat.size()), MPI_UNSIGNED, root, comm);
+
+    if (rank != root) {
+        sym.listed = header[1] != 0;
+        sym.complete = header[2] != 0;
+        sym.perms.assign(header[0], {});
+        for (size_t k = 0; k < header[0]; ++k) sym.perms[k].assign(flat.begin() + k * dim, flat.begin() + (k + 1) * dim);
+    }
+}
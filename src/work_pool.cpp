@@ -0,0 +1,104 @@
+#include "work_pool.h"
+#include "search.h"
+
+#include <thread>
+
+work_pool::work_pool(context& ctx, const unsigned int threads) : ctx(ctx), threads(threads) {
+    for (unsigned int t = 0; t < threads; ++t) deques.push_back(std::make_unique<work_deque<solution*>>());
+}
+
+work_pool::~work_pool() {
+    // subproblems left over by an interrupted search
+    solution* node;
+    for (auto& d : deques)
+        while (d->steal(node)) delete node;
+}
+
+bool work_pool::run(const solution& start, const std::function<void(const solution&)>& on_improved,
+                    unsigned long long& nodes) {
+    improved = &on_improved;
+    interrupted = false;
+    nodes_visited = 0;
+
+    pending = 1;
+    deques[0]->push(new solution(start));
+
+    // the calling thread is thread 0
+    std::vector<std::thread> helpers;
+    for (unsigned int t = 1; t < threads; ++t) helpers.emplace_back([this, t] { work(t); });
+    work(0);
+    for (auto& h : helpers) h.join();
+
+    nodes = nodes_visited;
+
+    // threads also leave on the time limit without taking what is still queued
+    return !interrupted && pending == 0;
+}
+
+void work_pool::give(const unsigned int thread, solution&& node) {
+    pending++;
+    deques[thread]->push(new solution(std::move(node)));
+}
+
+bool work_pool::take(const unsigned int thread, solution*& node) {
+    if (deques[thread]->pop(node)) return true;
+    for (unsigned int k = 1; k < threads; ++k)
+        if (deques[(thread + k) % threads]->steal(node)) return true;
+    return false;
+}
+
+void work_pool::work(const unsigned int thread) {
+    const bool least_constraining = ctx.branch_value == value_rule::least_constraining;
+    switch (ctx.branch_node) {
+        case node_rule::dsatur_degree:
+            if (least_constraining) work<dsatur_degree_node, least_constraining_values>(thread);
+            else work<dsatur_degree_node, first_fit_values>(thread);
+            break;
+        case node_rule::dsatur_free_degree:
+            if (least_constraining) work<dsatur_free_degree_node, least_constraining_values>(thread);
+            else work<dsatur_free_degree_node, first_fit_values>(thread);
+            break;
+        case node_rule::domain_degree:
+            if (least_constraining) work<domain_degree_node, least_constraining_values>(thread);
+            else work<domain_degree_node, first_fit_values>(thread);
+            break;
+        default:
+            if (least_constraining) work<dsatur_node, least_constraining_values>(thread);
+            else work<dsatur_node, first_fit_values>(thread);
+    }
+}
+
+template <typename Node, typename Value>
+void work_pool::work(const unsigned int thread) {
+    const auto report = [this](const solution& s) {
+        std::lock_guard<std::mutex> lock(improved_mutex);
+        (*improved)(s);
+    };
+
+    while (true) {
+        solution* node;
+        if (take(thread, node)) {
+            search_engine<Node, Value> engine(ctx, *node, threads > 1 ? this : nullptr, thread);
+            delete node;
+
+            if (!engine.run(report)) interrupted = true;
+            nodes_visited += engine.nodes;
+            pending--;
+            continue;
+        }
+
+        if (pending == 0 || interrupted) return;
+
+        // wait for another thread to hand out work
+        idle++;
+        while (pending > 0 && !interrupted && !ctx.stop) {
+            bool queued = false;
+            for (unsigned int k = 0; k < threads && !queued; ++k) queued = !deques[k]->empty();
+            if (queued) break;
+            std::this_thread::yield();
+        }
+        idle--;
+
+        if (ctx.stop) return;
+    }
+}